@@ -0,0 +1,115 @@
+//--------------------------------------------------------------------
+// EPOCH.CPP
+// Implementation of the EpochManager class
+// Author: [Your Name]
+//--------------------------------------------------------------------
+// EpochManager class:
+//   Implements epoch-based memory reclamation so that readers can walk
+//   shared data without locks while a writer replaces it.
+//   Using the following methods:
+//      EpochManager - constructor that starts at epoch 1 with no readers
+//      ~EpochManager - destructor that frees everything still retired
+//      enter - pins the current epoch for a reader
+//      exit - unpins a reader
+//      retire - hands replaced data to the manager for later deletion
+//      reclaim - frees retired data that no reader can still reference
+//   Assumptions:
+//      - retire and reclaim are called by one writer at a time
+//--------------------------------------------------------------------
+
+#include <thread>
+
+#include "Epoch.h"
+
+using namespace std;
+
+//------------------------------- EpochManager --------------------------------
+// EpochManager constructor
+// Preconditions:  None
+// Postconditions: The global epoch is 1, no readers are pinned and nothing
+//                 is retired
+EpochManager::EpochManager() : globalEpoch(1) {
+   for (int s = 0; s < MAX_READERS; s++) {
+      slots[s].store(0);
+   }
+}
+
+//------------------------------- ~EpochManager -------------------------------
+// Destructor for the EpochManager class
+// Preconditions:  No readers are pinned
+// Postconditions: All retired data has been freed
+EpochManager::~EpochManager() {
+   for (size_t r = 0; r < retired.size(); r++) {
+      retired[r].deleter(retired[r].ptr);
+   }
+   retired.clear();
+}
+
+//----------------------------------- enter -----------------------------------
+// Pins the current epoch for a reader
+// Preconditions:  None
+// Postconditions: Returns the slot holding the pin. Data retired from now on
+//                 is not freed until exit is called with that slot.
+int EpochManager::enter() {
+   for (;;) {
+      for (int s = 0; s < MAX_READERS; s++) {
+         unsigned long expected = 0;
+         // all operations are seq_cst: a writer that misses this pin in
+         // reclaim has already published its replacement, so every load
+         // made after the pin sees the new data
+         if (slots[s].compare_exchange_strong(expected, globalEpoch.load())) {
+            return s;
+         }
+      }
+      this_thread::yield(); // every slot is busy
+   }
+}
+
+//----------------------------------- exit ------------------------------------
+// Unpins a reader
+// Preconditions:  slot was returned by enter and has not been exited
+// Postconditions: The slot is free for another reader
+void EpochManager::exit(int slot) {
+   slots[slot].store(0);
+}
+
+//---------------------------------- retire -----------------------------------
+// Hands data that is no longer reachable from shared pointers to the manager
+// Preconditions:  ptr has already been unpublished by the writer
+// Postconditions: deleter(ptr) runs once no pinned reader can still see ptr,
+//                 at the latest when the manager is destroyed
+void EpochManager::retire(void* ptr, void (*deleter)(void*)) {
+   Retired item;
+   item.ptr = ptr;
+   item.deleter = deleter;
+   item.epoch = globalEpoch.fetch_add(1);
+   retired.push_back(item);
+   reclaim();
+}
+
+//---------------------------------- reclaim ----------------------------------
+// Frees retired data that no pinned reader can still reference
+// Preconditions:  None
+// Postconditions: Every retired item older than the oldest pinned epoch
+//                 has been deleted
+void EpochManager::reclaim() {
+   unsigned long oldest = globalEpoch.load();
+   for (int s = 0; s < MAX_READERS; s++) {
+      unsigned long pinned = slots[s].load();
+      if (pinned != 0 && pinned < oldest) {
+         oldest = pinned;
+      }
+   }
+
+   // readers pinned after an item's epoch loaded its replacement
+   size_t kept = 0;
+   for (size_t r = 0; r < retired.size(); r++) {
+      if (retired[r].epoch < oldest) {
+         retired[r].deleter(retired[r].ptr);
+      }
+      else {
+         retired[kept++] = retired[r];
+      }
+   }
+   retired.resize(kept);
+}
@@ -0,0 +1,103 @@
+//--------------------------------------------------------------------
+// EPOCH.H
+// Declaration of the EpochManager class
+// Author: [Your Name]
+//--------------------------------------------------------------------
+// EpochManager class:
+//   Implements epoch-based memory reclamation so that readers can walk
+//   shared data without locks while a writer replaces it. Readers pin
+//   the current epoch before loading shared pointers, and a writer
+//   retires replaced data instead of deleting it. Retired data is only
+//   freed once every reader that could still see it has unpinned.
+//   Using the following methods:
+//      EpochManager - constructor that starts at epoch 1 with no readers
+//      ~EpochManager - destructor that frees everything still retired
+//      enter - pins the current epoch for a reader
+//      exit - unpins a reader
+//      retire - hands replaced data to the manager for later deletion
+//      reclaim - frees retired data that no reader can still reference
+//   Assumptions:
+//      - retire and reclaim are called by one writer at a time
+//      - No more than MAX_READERS readers are pinned at once; extra
+//        readers wait for a free slot
+//--------------------------------------------------------------------
+
+#pragma once
+#include <atomic>
+#include <vector>
+
+using namespace std;
+
+class EpochManager {
+public:
+   static const int MAX_READERS = 64;
+
+   //--------------------------------- ReadGuard ---------------------------------
+   // Pins the epoch for the lifetime of the guard
+   // Preconditions:  None
+   // Postconditions: The calling thread is pinned until the guard is destroyed
+   class ReadGuard {
+   public:
+      ReadGuard(EpochManager& m) : manager(m), slot(m.enter()) {}
+      ~ReadGuard() { manager.exit(slot); }
+      ReadGuard(const ReadGuard&) = delete;
+      ReadGuard& operator=(const ReadGuard&) = delete;
+   private:
+      EpochManager& manager;
+      int slot;
+   };
+
+   //------------------------------- EpochManager --------------------------------
+   // EpochManager constructor
+   // Preconditions:  None
+   // Postconditions: The global epoch is 1, no readers are pinned and nothing
+   //                 is retired
+   EpochManager();
+
+   //------------------------------- ~EpochManager -------------------------------
+   // Destructor for the EpochManager class
+   // Preconditions:  No readers are pinned
+   // Postconditions: All retired data has been freed
+   ~EpochManager();
+
+   EpochManager(const EpochManager&) = delete;
+   EpochManager& operator=(const EpochManager&) = delete;
+
+   //----------------------------------- enter -----------------------------------
+   // Pins the current epoch for a reader
+   // Preconditions:  None
+   // Postconditions: Returns the slot holding the pin. Data retired from now on
+   //                 is not freed until exit is called with that slot.
+   int enter();
+
+   //----------------------------------- exit ------------------------------------
+   // Unpins a reader
+   // Preconditions:  slot was returned by enter and has not been exited
+   // Postconditions: The slot is free for another reader
+   void exit(int slot);
+
+   //---------------------------------- retire -----------------------------------
+   // Hands data that is no longer reachable from shared pointers to the manager
+   // Preconditions:  ptr has already been unpublished by the writer
+   // Postconditions: deleter(ptr) runs once no pinned reader can still see ptr,
+   //                 at the latest when the manager is destroyed
+   void retire(void* ptr, void (*deleter)(void*));
+
+   //---------------------------------- reclaim ----------------------------------
+   // Frees retired data that no pinned reader can still reference
+   // Preconditions:  None
+   // Postconditions: Every retired item older than the oldest pinned epoch
+   //                 has been deleted
+   void reclaim();
+
+private:
+   struct Retired {
+      void* ptr; // unpublished data
+      void (*deleter)(void*); // frees ptr
+      unsigned long epoch; // epoch in which ptr was unpublished
+   };
+
+   atomic<unsigned long> globalEpoch;
+   atomic<unsigned long> slots[MAX_READERS]; // pinned epoch per reader, 0 if free
+   vector<Retired> retired;
+};
@@ -1,11 +1,13 @@
 //--------------------------------------------------------------------
 // GRAPH.CPP
-// Implementation of the Graph class
+// Implementation of the BasicGraph class template
 // Author: [Your Name]
 //--------------------------------------------------------------------
-// Graph class:
-//   Implements a graph data structure and various graph algorithms
-//   using the following methods:
+// BasicGraph<VertexId, Weight> class template:
+//   Implements a graph data structure and various graph algorithms.
+//   Explicit instantiations for the supported vertex id and weight
+//   types are at the end of this file.
+//   Uses the following methods:
 //      Graph - constructor that initializes an empty graph
 //      ~Graph - destructor that deallocates memory used by the graph
 //      insertEdge - adds an edge to the graph
@@ -13,16 +15,41 @@
 //      printEdges - displays all edges in the graph
 //      printVertices - displays all vertices in the graph
 //      displayAll - displays the shortest path between all vertices in the graph
+//      getVersion - returns the number of published edge updates
+//      setQueueStrategy - selects the priority queue used by findShortestPath
+//      findShortestPathSharded - runs findShortestPath across worker processes
+//                                into a memory-mapped result file
+//      attachResults - displays shortest paths from a result file
+//      kShortestPaths - returns the k shortest loopless paths between two vertices
+//      findShortestPathFrom - returns single-source shortest paths without
+//                             touching the table
+//      isReachable - answers in O(1) whether any path joins two vertices
+//      getSize - returns the number of vertices
+//      reorderVertices - renumbers the internal layout of the vertices for
+//                        locality while keeping external ids unchanged
+//   Concurrency:
+//      - Queries may run concurrently with insertEdge and removeEdge; edge
+//        lists are copied on write and reclaimed through EpochManager
 //   Assumptions:
 //      - The insertEdge method assumes that the src and dst vertex numbers are valid
 //      - The removeEdge method assumes that the edge to be removed exists in the graph
 //      - The input to the displayAll method should result in a connected graph
+//      - Weights are non-negative; integer distances saturate at the sentinel
 //--------------------------------------------------------------------
 
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <queue>
 #include <iomanip>
+#include <set>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
 
 #include "Graph.h"
 
@@ -34,31 +61,38 @@ using namespace std;
 // Postconditions: A graph object is created and initialized with the following:
 //    - All vertices set to nullptr
 //    - All edges set to nullptr
-//    - T[i][j].dist set to INT_MAX for all i and j
+//    - T[i][j].dist set to infinity for all i and j
 //    - T[i][j].visited set to false for all i and j
-//    - T[i][j].path set to -1 for all i and j
+//    - T[i][j].path set to NO_VERTEX for all i and j
 //    - size set to 0
-Graph::Graph() {
+template <typename VertexId, typename Weight>
+BasicGraph<VertexId, Weight>::BasicGraph() {
    for (int v = 1; v < MAX_VERTICES; v++) {
       vertices[v].data = nullptr;
-      vertices[v].edgeHead = nullptr;
+      vertices[v].edgeHead.store(nullptr);
    }
 
    for (int i = 0; i < MAX_VERTICES; i++) {
       for (int j = 0; j < MAX_VERTICES; j++) {
-         T[i][j].dist = INT_MAX;
+         T[i][j].dist = WeightTraits<Weight>::infinity();
          T[i][j].visited = false;
-         T[i][j].path = -1;
+         T[i][j].path = NO_VERTEX;
       }
    }
    size = 0;
+   version.store(0);
+   maxWeight.store(0);
+   queueStrategy.store(AUTO);
+   reach.store(nullptr);
+   resetIds();
 }
 
 //------------------------------ Graph(const Graph& g) ------------------------------
 // Constructs a copy of a graph object
 // Preconditions: The graph object g is initialized
 // Postconditions: A new graph object is created with the same values as the original graph object g
-Graph::Graph(const Graph& g) : Graph() {
+template <typename VertexId, typename Weight>
+BasicGraph<VertexId, Weight>::BasicGraph(const BasicGraph& g) : BasicGraph() {
    copy(g);
 }
 
@@ -66,7 +100,8 @@ Graph::Graph(const Graph& g) : Graph() {
 // Destructor for the Graph class
 // Preconditions:  Graph object has been created
 // Postconditions: Graph object's memory is deallocated and its resources are freed
-Graph::~Graph() {
+template <typename VertexId, typename Weight>
+BasicGraph<VertexId, Weight>::~BasicGraph() {
    clear();
 }
 
@@ -75,7 +110,8 @@ Graph::~Graph() {
 // Preconditions:  The graph object must be properly initialized.
 // Postconditions: The graph object is copied from the input graph object, including
 //                 all vertices and edges. The previous data in the graph object is deleted.
-Graph& Graph::operator=(const Graph& g) {
+template <typename VertexId, typename Weight>
+BasicGraph<VertexId, Weight>& BasicGraph<VertexId, Weight>::operator=(const BasicGraph& g) {
    if (this == &g) { // check self-assignment
       return *this;
    }
@@ -91,7 +127,8 @@ Graph& Graph::operator=(const Graph& g) {
 // Preconditions:  infile has been successfully opened and the file contains
 //                 properly formated data (according to the program specs)
 // Postconditions: One graph is read from infile and stored in the object
-void Graph::buildGraph(ifstream& infile) {
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::buildGraph(ifstream& infile) {
    string description;
 
    infile >> size;                          // data member stores array size
@@ -101,28 +138,34 @@ void Graph::buildGraph(ifstream& infile) {
       // get descriptions of vertices
       for (int v = 1; v <= size; v++) {
          getline(infile, description);
-         vertices[v].edgeHead = nullptr;
+         vertices[v].edgeHead.store(nullptr);
          vertices[v].data = new Vertex(description);
          //vertices[v].data = new Vertex;
          //infile >> *vertices[v].data;
       }
    // fill cost edge array
-   int src = 1, dest = 1, weight = 1;
+   int src = 1, dest = 1;
+   Weight weight = 1;
    for (;;) {
       infile >> src >> dest >> weight;
       if (src == 0 || infile.eof())
          break;
       insertEdge(src, dest, weight);
    }
+
+   // index once all edges are in rather than after every insertEdge
+   lock_guard<mutex> lock(writeLock);
+   publishReach(buildReach());
 }
 
 //-------------------------------- printVertices ---------------------------------
 // Prints the vertices in the graph
 // Preconditions:  Graph object is initialized with vertices
 // Postconditions: The description of each vertex in the graph is printed to the console
-void Graph::printVertices() {
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::printVertices() {
    for (int i = 1; i <= size; i++) {
-      cout << "Vertex " << i << ": " << vertices[i].data->getDescription() << endl;
+      cout << "Vertex " << i << ": " << vertices[toInternal[i]].data->getDescription() << endl;
    }
 }
 
@@ -130,11 +173,13 @@ void Graph::printVertices() {
 // Prints all of the edges in the graph.
 // Preconditions: The graph must be initialized with vertices and edges.
 // Postconditions: All of the edges in the graph are printed to the console.
-void Graph::printEdges() {
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::printEdges() {
+   EpochManager::ReadGuard guard(epochs);
    for (int i = 1; i <= size; i++) {
-      EdgeNode* currentEdge = vertices[i].edgeHead;
+      EdgeNode* currentEdge = vertices[toInternal[i]].edgeHead.load();
       while (currentEdge != nullptr) {
-         cout << i << " -> " << currentEdge->adjVertex
+         cout << i << " -> " << toExternal[currentEdge->adjVertex]
             << " with weight " << currentEdge->weight << endl;
          currentEdge = currentEdge->nextEdge;
       }
@@ -145,34 +190,65 @@ void Graph::printEdges() {
 // Inserts an edge between two vertices of the graph
 // Preconditions:  The graph has been initialized with vertices, and `src` and `dest` are valid vertices in the graph.
 // Postconditions: An edge is inserted between the vertices `src` and `dest` with a weight of `weight`.
-void Graph::insertEdge(int src, int dst, int weight) {
-   EdgeNode* currentEdge = vertices[src].edgeHead;
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::insertEdge(int src, int dst, Weight weight) {
+   lock_guard<mutex> lock(writeLock);
+   src = toInternal[src];
+   dst = toInternal[dst];
+
+   // raise the bound before the edge becomes visible to queries
+   if (weight > maxWeight.load()) {
+      maxWeight.store(weight);
+   }
+
+   // copy the published list, replacing the weight if dst already exists
+   EdgeNode* newHead = nullptr;
    EdgeNode* previousEdge = nullptr;
+   bool replaced = false;
 
-   // check if dst exists
+   for (EdgeNode* currentEdge = vertices[src].edgeHead.load(); currentEdge != nullptr;
+        currentEdge = currentEdge->nextEdge) {
+      EdgeNode* newEdge = new EdgeNode;
+      newEdge->adjVertex = currentEdge->adjVertex;
+      newEdge->weight = currentEdge->weight;
+      newEdge->nextEdge = nullptr;
 
-   while (currentEdge != nullptr ) {
-      if (currentEdge->adjVertex == dst) {
+      if (currentEdge->adjVertex == static_cast<VertexId>(dst)) {
          // replace weight
-         currentEdge->weight = weight;
-         return;
+         newEdge->weight = weight;
+         replaced = true;
       }
-      previousEdge = currentEdge;
-      currentEdge = currentEdge->nextEdge;
+
+      if (previousEdge == nullptr) { // update head
+         newHead = newEdge;
+      }
+      else {
+         previousEdge->nextEdge = newEdge;
+      }
+      previousEdge = newEdge;
    }
 
-   EdgeNode* newEdge = new EdgeNode;
-   newEdge->adjVertex = dst;
-   newEdge->weight = weight;
+   if (!replaced) {
+      EdgeNode* newEdge = new EdgeNode;
+      newEdge->adjVertex = static_cast<VertexId>(dst);
+      newEdge->weight = weight;
+      newEdge->nextEdge = nullptr;
 
-   if (previousEdge == nullptr) { // update head
-      newEdge->nextEdge = vertices[src].edgeHead;
-      vertices[src].edgeHead = newEdge;
-      return;
+      if (previousEdge == nullptr) { // update head
+         newHead = newEdge;
+      }
+      else {
+         previousEdge->nextEdge = newEdge;
+      }
    }
 
-   previousEdge->nextEdge = newEdge;
-   newEdge->nextEdge = nullptr;   
+   publishEdges(src, newHead);
+
+   // a new edge only matters to the index if it joins unreachable vertices
+   const ReachIndex* index = reach.load();
+   if (index != nullptr && !index->reaches[index->component[src]][dst]) {
+      publishReach(buildReach());
+   }
 }
 
 //-------------------------------- removeEdge ---------------------------------
@@ -180,24 +256,87 @@ void Graph::insertEdge(int src, int dst, int weight) {
 // Preconditions:  src and dst vertices must exist in the graph
 //                 and have an edge between them
 // Postconditions: The edge between src and dst vertices is removed from the graph
-void Graph::removeEdge(int src, int dst) {
-   EdgeNode* currentEdge = vertices[src].edgeHead;
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::removeEdge(int src, int dst) {
+   lock_guard<mutex> lock(writeLock);
+   src = toInternal[src];
+   dst = toInternal[dst];
+
+   // copy the published list without the edge to dst
+   EdgeNode* newHead = nullptr;
    EdgeNode* previousEdge = nullptr;
+   bool removed = false;
 
-   while (currentEdge != nullptr) {
-      if (currentEdge->adjVertex == dst) {
-         if (previousEdge == nullptr) {
-            vertices[src].edgeHead = currentEdge->nextEdge;
-         }
-         else {
-            previousEdge->nextEdge = currentEdge->nextEdge;
-         }
-         delete currentEdge;
-         return;
+   for (EdgeNode* currentEdge = vertices[src].edgeHead.load(); currentEdge != nullptr;
+        currentEdge = currentEdge->nextEdge) {
+      if (currentEdge->adjVertex == static_cast<VertexId>(dst)) {
+         removed = true;
+         continue;
+      }
+
+      EdgeNode* newEdge = new EdgeNode;
+      newEdge->adjVertex = currentEdge->adjVertex;
+      newEdge->weight = currentEdge->weight;
+      newEdge->nextEdge = nullptr;
+
+      if (previousEdge == nullptr) {
+         newHead = newEdge;
       }
-      previousEdge = currentEdge;
-      currentEdge = currentEdge->nextEdge;
+      else {
+         previousEdge->nextEdge = newEdge;
+      }
+      previousEdge = newEdge;
+   }
+
+   if (!removed) { // nothing to publish
+      deleteEdges(newHead);
+      return;
+   }
+
+   publishEdges(src, newHead);
+
+   // while src still reaches dst, any path through the removed edge can go
+   // around it, so no component or reach set changes
+   if (reach.load() != nullptr && !stillReaches(src, dst)) {
+      publishReach(buildReach());
+   }
+}
+
+//-------------------------------- getVersion ---------------------------------
+// Returns the number of edge updates published since the graph was built
+// Preconditions:  None
+// Postconditions: Returns the current adjacency version
+template <typename VertexId, typename Weight>
+unsigned long BasicGraph<VertexId, Weight>::getVersion() const {
+   return version.load();
+}
+
+//----------------------------- setQueueStrategy ------------------------------
+// Selects the priority queue used by findShortestPath
+// Preconditions:  None
+// Postconditions: Subsequent shortest path runs use strategy. AUTO uses DIAL
+//                 while the largest edge weight inserted so far is at most
+//                 DIAL_MAX_WEIGHT, and RADIX otherwise. DIAL and RADIX
+//                 fall back to BINARY_HEAP for floating point weights.
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::setQueueStrategy(QueueStrategy strategy) {
+   queueStrategy.store(strategy);
+}
+
+//----------------------------- getQueueStrategy ------------------------------
+// Returns the queue findShortestPath will use
+// Preconditions:  None
+// Postconditions: Returns the selected strategy with AUTO resolved
+template <typename VertexId, typename Weight>
+typename BasicGraph<VertexId, Weight>::QueueStrategy BasicGraph<VertexId, Weight>::getQueueStrategy() const {
+   QueueStrategy strategy = queueStrategy.load();
+   if (!WeightTraits<Weight>::isInteger) { // monotone queues need integer keys
+      return strategy == SCAN ? SCAN : BINARY_HEAP;
    }
+   if (strategy != AUTO) {
+      return strategy;
+   }
+   return maxWeight.load() <= DIAL_MAX_WEIGHT ? DIAL : RADIX;
 }
 
 //-------------------------------- findShortestPath ----------------------------
@@ -206,77 +345,1084 @@ void Graph::removeEdge(int src, int dst) {
 // Precondition: The graph must be initialized with vertices and edges.
 // Postcondition: The shortest path is stored in a 2D table T[MAX_VERTICES][MAX_VERTICES], 
 //                where T[i][j] represents the cost of the shortest path from vertex i to vertex j.
-void Graph::findShortestPath() {
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::findShortestPath() {
+   Table row[MAX_VERTICES];
+
+   {
+      // show the rows computed here, not an attached file
+      lock_guard<mutex> lock(tableLock);
+      results.close();
+   }
+
    for (int i = 1; i <= size; i++) {
+      {
+         // pin per source so that long runs do not hold back reclamation
+         EpochManager::ReadGuard guard(epochs);
+         dijkstra(i, row);
+      }
+
+      lock_guard<mutex> lock(tableLock);
       for (int j = 1; j <= size; j++) {
-         T[i][j].dist = INT_MAX;
-         T[i][j].visited = false;
-         T[i][j].path = -1;        
+         T[i][j] = row[j];
+      }
+   }
+}
+
+//----------------------------- findShortestPathSharded ------------------------------
+// Calculates the same table as findShortestPath with the sources split across
+// worker processes that write into a shared memory-mapped file at path
+// Preconditions:  The graph is initialized, workers >= 1, deadlineMs > 0, and
+//                 no other thread is using the graph (a forked worker only has
+//                 the calling thread)
+// Postconditions: Returns true if every row was written; path is then attached
+//                 as by attachResults. Returns false if the file cannot be
+//                 created or a range fails every attempt.
+template <typename VertexId, typename Weight>
+bool BasicGraph<VertexId, Weight>::findShortestPathSharded(const char* path, int workers,
+   int deadlineMs, ShardHook workerStart) {
+   typedef chrono::steady_clock Clock;
+
+   {
+      // path may be the attached file, which create is about to truncate
+      lock_guard<mutex> lock(tableLock);
+      results.close();
+   }
+
+   ResultFile file;
+   if (!file.create(path, size, sizeof(Table), tableType())) {
+      return false;
+   }
+
+   int shards = workers * SHARDS_PER_WORKER;
+   if (shards > size) {
+      shards = size;
+   }
+
+   vector<int> pending; // ranges waiting for a worker
+   vector<int> attempts(shards, 0);
+   vector<pid_t> running; // worker of each running range
+   vector<int> runningShard;
+   vector<Clock::time_point> runningSince;
+   bool failed = false;
+
+   for (int s = shards - 1; s >= 0; s--) {
+      pending.push_back(s);
+   }
+
+   while (!running.empty() || (!failed && !pending.empty())) {
+      // start workers for pending ranges
+      while (!failed && !pending.empty() && static_cast<int>(running.size()) < workers) {
+         int s = pending.back();
+         pending.pop_back();
+         attempts[s]++;
+
+         int first = 1 + s * size / shards;
+         int last = (s + 1) * size / shards;
+
+         pid_t pid = fork();
+         if (pid == 0) {
+            if (workerStart != nullptr) {
+               workerStart(s, attempts[s]);
+            }
+            runShard(file, first, last);
+            _exit(0); // skip atexit handlers and the parent's buffered output
+         }
+
+         if (pid > 0) {
+            running.push_back(pid);
+            runningShard.push_back(s);
+            runningSince.push_back(Clock::now());
+         }
+         else if (attempts[s] < SHARD_ATTEMPTS) {
+            pending.push_back(s);
+         }
+         else {
+            failed = true;
+         }
+      }
+
+      if (running.empty()) {
+         break;
+      }
+
+      // collect finished workers without reaping unrelated children
+      bool reaped = false;
+      for (size_t w = 0; w < running.size(); w++) {
+         int status = 0;
+         if (waitpid(running[w], &status, WNOHANG) != running[w]) {
+            if (Clock::now() - runningSince[w] < chrono::milliseconds(deadlineMs)) {
+               continue;
+            }
+
+            // a hung worker loses its range like one that crashed
+            kill(running[w], SIGKILL);
+            waitpid(running[w], &status, 0);
+         }
+
+         int s = runningShard[w];
+         int first = 1 + s * size / shards;
+         int last = (s + 1) * size / shards;
+
+         bool complete = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+         for (int src = first; complete && src <= last; src++) {
+            complete = file.isDone(src);
+         }
+
+         if (!complete) {
+            if (attempts[s] < SHARD_ATTEMPTS) {
+               pending.push_back(s);
+            }
+            else {
+               failed = true;
+            }
+         }
+
+         running.erase(running.begin() + w);
+         runningShard.erase(runningShard.begin() + w);
+         runningSince.erase(runningSince.begin() + w);
+         reaped = true;
+         break;
+      }
+
+      if (!reaped) {
+         usleep(1000);
+      }
+   }
+
+   file.close();
+   return !failed && attachResults(path);
+}
+
+//--------------------------------- attachResults ----------------------------------
+// Maps a result file written by findShortestPathSharded for display
+// Preconditions:  path was written for a graph with the same vertices and edges
+// Postconditions: Returns true if path holds a complete table of this graph's
+//                 size and type; displayAll and display then read it instead of
+//                 the in-memory table until the next findShortestPath call.
+//                 Returns false and leaves the display source unchanged otherwise.
+template <typename VertexId, typename Weight>
+bool BasicGraph<VertexId, Weight>::attachResults(const char* path) {
+   ResultFile file;
+   if (!file.open(path) || file.getSize() != size || file.getEntryBytes() != sizeof(Table)
+      || file.getEntryType() != tableType()) {
+      return false;
+   }
+
+   for (int src = 1; src <= size; src++) {
+      if (!file.isDone(src)) {
+         return false;
+      }
+   }
+
+   lock_guard<mutex> lock(tableLock);
+   file.close();
+   return results.open(path);
+}
+
+//-------------------------------- tableType ---------------------------------
+// Returns the entry type tag of Table in result files
+// Preconditions:  None
+// Postconditions: Returns a tag built from the sizes of VertexId and Weight
+//                 and whether Weight is floating point or signed
+template <typename VertexId, typename Weight>
+uint32_t BasicGraph<VertexId, Weight>::tableType() {
+   return static_cast<uint32_t>(sizeof(VertexId))
+      | static_cast<uint32_t>(sizeof(Weight)) << 8
+      | static_cast<uint32_t>(is_floating_point<Weight>::value) << 16
+      | static_cast<uint32_t>(is_signed<Weight>::value) << 17;
+}
+
+//-------------------------------- runShard ---------------------------------
+// Computes a range of rows into a result file; runs in a worker process
+// Preconditions:  file is mapped for writing and 1 <= first <= last <= size
+// Postconditions: Rows first..last of external sources are written by
+//                 external id and marked done
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::runShard(ResultFile& file, int first, int last) const {
+   EpochManager::ReadGuard guard(epochs);
+   Table row[MAX_VERTICES];
+
+   for (int src = first; src <= last; src++) {
+      dijkstra(toInternal[src], row);
+
+      // files do not record the layout, so they hold external ids only
+      Table* stored = static_cast<Table*>(file.row(src));
+      for (int j = 1; j <= size; j++) {
+         stored[j] = row[toInternal[j]];
+         stored[j].path = static_cast<VertexId>(toExternal[stored[j].path]);
+      }
+      file.markDone(src);
+   }
+}
+
+//-------------------------------- kShortestPaths ---------------------------------
+// Finds up to k shortest loopless paths from src to dst using Yen's algorithm
+// Preconditions:  src and dst are valid vertices and k >= 0. May run concurrently
+//                 with edge updates; it then answers for one set of edge lists.
+// Postconditions: Returns the paths in order of nondecreasing cost, with no
+//                 vertex repeated within a path; fewer than k if no more exist.
+template <typename VertexId, typename Weight>
+vector<typename BasicGraph<VertexId, Weight>::Path>
+BasicGraph<VertexId, Weight>::kShortestPaths(int src, int dst, int k) const {
+   vector<Path> accepted;
+   if (k <= 0 || !isReachable(src, dst)) {
+      return accepted;
+   }
+   src = toInternal[src];
+   dst = toInternal[dst];
+
+   EdgeArrays edges;
+   {
+      EpochManager::ReadGuard guard(epochs);
+      snapshotEdges(edges);
+   }
+
+   // one reverse Dijkstra serves every spur search
+   vector<Weight> toDst;
+   vector<int> next;
+   treeToTarget(edges, dst, toDst, next);
+
+   vector<bool> banned(size + 1, false);
+   Path first;
+   if (!spurPath(edges, src, dst, banned, toDst, next, first)) {
+      return accepted;
+   }
+   accepted.push_back(first);
+
+   // candidates ordered by cost, then by vertices; equal paths collapse
+   set<pair<Weight, vector<int>>> candidates;
+
+   while (static_cast<int>(accepted.size()) < k) {
+      const vector<int> previous = accepted.back().vertices;
+      Weight rootCost = 0;
+
+      for (size_t i = 0; i + 1 < previous.size(); i++) {
+         int spur = previous[i];
+
+         // hide the next edge of every accepted path that shares this root
+         vector<int> hidden;
+         for (size_t p = 0; p < accepted.size(); p++) {
+            const vector<int>& other = accepted[p].vertices;
+            if (other.size() > i + 1 && equal(previous.begin(), previous.begin() + i + 1,
+               other.begin())) {
+               int e = findEdge(edges, spur, other[i + 1]);
+               if (e >= 0 && !edges.masked[e]) {
+                  edges.masked[e] = true;
+                  hidden.push_back(e);
+               }
+            }
+         }
+
+         // the root path may not be revisited
+         for (size_t r = 0; r < i; r++) {
+            banned[previous[r]] = true;
+         }
+
+         Path spurRest;
+         if (spurPath(edges, spur, dst, banned, toDst, next, spurRest)) {
+            vector<int> vertices(previous.begin(), previous.begin() + i);
+            vertices.insert(vertices.end(), spurRest.vertices.begin(), spurRest.vertices.end());
+            candidates.insert(make_pair(WeightTraits<Weight>::add(rootCost, spurRest.cost),
+               vertices));
+         }
+
+         for (size_t h = 0; h < hidden.size(); h++) {
+            edges.masked[hidden[h]] = false;
+         }
+         for (size_t r = 0; r < i; r++) {
+            banned[previous[r]] = false;
+         }
+
+         rootCost = WeightTraits<Weight>::add(rootCost,
+            edges.weight[findEdge(edges, spur, previous[i + 1])]);
+      }
+
+      // a candidate may repeat an accepted path found from another root
+      bool found = false;
+      while (!candidates.empty() && !found) {
+         Path best;
+         best.cost = candidates.begin()->first;
+         best.vertices = candidates.begin()->second;
+         candidates.erase(candidates.begin());
+
+         found = true;
+         for (size_t p = 0; p < accepted.size() && found; p++) {
+            found = accepted[p].vertices != best.vertices;
+         }
+         if (found) {
+            accepted.push_back(best);
+         }
       }
 
-      T[i][i].dist = 0;
+      if (!found) {
+         break;
+      }
+   }
+
+   for (size_t p = 0; p < accepted.size(); p++) {
+      for (size_t v = 0; v < accepted[p].vertices.size(); v++) {
+         accepted[p].vertices[v] = toExternal[accepted[p].vertices[v]];
+      }
+   }
+   return accepted;
+}
+
+//----------------------------- findShortestPathFrom ------------------------------
+// Calculates the shortest paths from one source into caller-owned vectors
+// Preconditions:  May run concurrently with edge updates and other queries
+// Postconditions: Returns false if src is not a vertex. Otherwise returns true,
+//                 dist[v] is the cost from src to v (infinity if unreachable)
+//                 and path[v] is the vertex before v on that path, for v in 1..size
+template <typename VertexId, typename Weight>
+bool BasicGraph<VertexId, Weight>::findShortestPathFrom(int src, vector<Weight>& dist,
+   vector<int>& path) const {
+   if (src < 1 || src > size) {
+      return false;
+   }
+
+   Table row[MAX_VERTICES];
+   {
+      EpochManager::ReadGuard guard(epochs);
+      dijkstra(toInternal[src], row);
+   }
+
+   dist.assign(size + 1, WeightTraits<Weight>::infinity());
+   path.assign(size + 1, NO_VERTEX);
+   for (int v = 1; v <= size; v++) {
+      const Table& reached = row[toInternal[v]];
+      if (reached.visited) {
+         dist[v] = reached.dist;
+         path[v] = toExternal[reached.path];
+      }
+   }
+   return true;
+}
+
+//-------------------------------- isReachable ---------------------------------
+// Returns whether some path leads from src to dst, using the reachability
+// index of strongly connected components built with the graph
+// Preconditions:  May run concurrently with edge updates
+// Postconditions: Returns false if src or dst is not a vertex or dst is
+//                 provably unreachable from src; true otherwise
+template <typename VertexId, typename Weight>
+bool BasicGraph<VertexId, Weight>::isReachable(int src, int dst) const {
+   if (src < 1 || src > size || dst < 1 || dst > size) {
+      return false;
+   }
+
+   EpochManager::ReadGuard guard(epochs);
+   const ReachIndex* index = reach.load();
+   return index == nullptr
+      || index->reaches[index->component[toInternal[src]]][toInternal[dst]];
+}
+
+//---------------------------------- getSize -----------------------------------
+// Returns the number of vertices in the graph
+// Preconditions:  None
+// Postconditions: Returns size
+template <typename VertexId, typename Weight>
+int BasicGraph<VertexId, Weight>::getSize() const {
+   return size;
+}
 
-      int v = 0;  // smallest vertex
+//------------------------------- reorderVertices -------------------------------
+// Renumbers the internal layout so that vertices that share edges sit close
+// together in vertices[] and in the rows of T
+// Preconditions:  The graph is built and no other thread is using it
+// Postconditions: vertices[], the edge lists and T are permuted into order,
+//                 and every public method still uses the input file's ids.
+//                 An attached result file is detached.
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::reorderVertices(VertexOrder order) {
+   vector<int> placed = vertexOrder(order);
 
-      while (true) {
-         v = -1;
-         int min_dist = INT_MAX;
-         
-          // pick the vertex with the smallest distance in visited node
+   // newId[v] is the internal id that internal id v moves to
+   int newId[MAX_VERTICES];
+   newId[NO_VERTEX] = NO_VERTEX;
+   for (int p = 0; p < size; p++) {
+      newId[toInternal[placed[p]]] = p + 1;
+   }
+
+   // rebuild the lists in the new order, so that edge nodes are also
+   // allocated in the order Dijkstra walks them
+   Vertex* data[MAX_VERTICES];
+   EdgeNode* heads[MAX_VERTICES];
+   for (int p = 1; p <= size; p++) {
+      int v = toInternal[placed[p - 1]];
+      EdgeNode* previousEdge = nullptr;
+      data[p] = vertices[v].data;
+      heads[p] = nullptr;
+
+      for (EdgeNode* curr = vertices[v].edgeHead.load(); curr != nullptr; curr = curr->nextEdge) {
+         EdgeNode* newEdge = new EdgeNode;
+         newEdge->adjVertex = static_cast<VertexId>(newId[curr->adjVertex]);
+         newEdge->weight = curr->weight;
+         newEdge->nextEdge = nullptr;
+
+         if (previousEdge == nullptr) {
+            heads[p] = newEdge;
+         }
+         else {
+            previousEdge->nextEdge = newEdge;
+         }
+         previousEdge = newEdge;
+      }
+   }
+
+   for (int v = 1; v <= size; v++) {
+      deleteEdges(vertices[v].edgeHead.load());
+      vertices[v].data = data[v];
+      vertices[v].edgeHead.store(heads[v]);
+   }
+
+   for (int e = 1; e <= size; e++) {
+      toInternal[e] = newId[toInternal[e]];
+      toExternal[toInternal[e]] = e;
+   }
+
+   {
+      // move the computed rows along so that displayAll still shows them
+      lock_guard<mutex> lock(tableLock);
+      results.close();
+
+      vector<Table> previous(&T[0][0], &T[0][0] + MAX_VERTICES * MAX_VERTICES);
+      for (int i = 1; i <= size; i++) {
          for (int j = 1; j <= size; j++) {
-            if (T[i][j].visited == false ) {
-               if (T[i][j].dist < min_dist) {
-                  min_dist = T[i][j].dist;
-                  v = j;
+            Table moved = previous[i * MAX_VERTICES + j];
+            moved.path = static_cast<VertexId>(newId[moved.path]);
+            T[newId[i]][newId[j]] = moved;
+         }
+      }
+   }
+
+   if (reach.load() != nullptr) {
+      publishReach(buildReach());
+   }
+}
+
+//-------------------------------- vertexOrder ---------------------------------
+// Lists the vertices in the order reorderVertices lays them out
+// Preconditions:  No other thread is changing the edges
+// Postconditions: Returns every external id 1..size once, first to last
+template <typename VertexId, typename Weight>
+vector<int> BasicGraph<VertexId, Weight>::vertexOrder(VertexOrder order) const {
+   // locality does not depend on edge direction, so neighbours go both ways
+   vector<vector<int>> neighbours(size + 1);
+   for (int u = 1; u <= size; u++) {
+      for (EdgeNode* curr = vertices[toInternal[u]].edgeHead.load(); curr != nullptr;
+           curr = curr->nextEdge) {
+         int v = toExternal[curr->adjVertex];
+         if (v != u) {
+            neighbours[u].push_back(v);
+            neighbours[v].push_back(u);
+         }
+      }
+   }
+   for (int u = 1; u <= size; u++) {
+      sort(neighbours[u].begin(), neighbours[u].end());
+      neighbours[u].erase(unique(neighbours[u].begin(), neighbours[u].end()),
+         neighbours[u].end());
+   }
+
+   vector<int> placed;
+   if (order != BFS && order != REVERSE_CUTHILL_MCKEE) {
+      for (int u = 1; u <= size; u++) {
+         placed.push_back(u);
+      }
+      if (order == DEGREE) {
+         stable_sort(placed.begin(), placed.end(), [&neighbours](int a, int b) {
+            return neighbours[a].size() > neighbours[b].size();
+         });
+      }
+      return placed;
+   }
+
+   // breadth-first through one component at a time
+   vector<bool> seen(size + 1, false);
+   while (static_cast<int>(placed.size()) < size) {
+      int start = 0;
+      for (int u = 1; u <= size; u++) {
+         if (!seen[u] && (start == 0 || (order == REVERSE_CUTHILL_MCKEE
+            && neighbours[u].size() < neighbours[start].size()))) {
+            start = u;
+         }
+      }
+
+      size_t next = placed.size();
+      placed.push_back(start);
+      seen[start] = true;
+      while (next < placed.size()) {
+         int u = placed[next++];
+         vector<int> found;
+         for (size_t n = 0; n < neighbours[u].size(); n++) {
+            if (!seen[neighbours[u][n]]) {
+               found.push_back(neighbours[u][n]);
+            }
+         }
+         if (order == REVERSE_CUTHILL_MCKEE) {
+            stable_sort(found.begin(), found.end(), [&neighbours](int a, int b) {
+               return neighbours[a].size() < neighbours[b].size();
+            });
+         }
+         for (size_t n = 0; n < found.size(); n++) {
+            seen[found[n]] = true;
+            placed.push_back(found[n]);
+         }
+      }
+   }
+
+   if (order == REVERSE_CUTHILL_MCKEE) {
+      reverse(placed.begin(), placed.end());
+   }
+   return placed;
+}
+
+//-------------------------------- resetIds ---------------------------------
+// Makes every internal id equal to its external id
+// Preconditions:  None
+// Postconditions: toInternal and toExternal are the identity
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::resetIds() {
+   for (int v = 0; v < MAX_VERTICES; v++) {
+      toInternal[v] = v;
+      toExternal[v] = v;
+   }
+}
+
+//-------------------------------- buildReach ---------------------------------
+// Finds the strongly connected components with an iterative Tarjan pass and
+// the vertices reachable from each one over the condensation DAG
+// Preconditions:  No other thread is changing the edges
+// Postconditions: Returns a new index of the current edges
+template <typename VertexId, typename Weight>
+typename BasicGraph<VertexId, Weight>::ReachIndex* BasicGraph<VertexId, Weight>::buildReach() const {
+   ReachIndex* index = new ReachIndex;
+
+   int order[MAX_VERTICES]; // discovery order, 0 if not yet discovered
+   int low[MAX_VERTICES]; // lowest order reachable within the DFS subtree
+   bool onStack[MAX_VERTICES];
+   int stack[MAX_VERTICES]; // Tarjan's stack of open vertices
+   int stackSize = 0;
+   int callVertex[MAX_VERTICES]; // explicit DFS call stack replacing recursion
+   EdgeNode* callEdge[MAX_VERTICES]; // next edge to explore at each level
+   int depth = 0;
+   int discovered = 0;
+   int components = 0;
+
+   for (int v = 1; v <= size; v++) {
+      order[v] = 0;
+      onStack[v] = false;
+      index->component[v] = -1;
+   }
+
+   for (int root = 1; root <= size; root++) {
+      if (order[root] != 0) {
+         continue;
+      }
+
+      order[root] = low[root] = ++discovered;
+      stack[stackSize++] = root;
+      onStack[root] = true;
+      callVertex[depth] = root;
+      callEdge[depth++] = vertices[root].edgeHead.load();
+
+      while (depth > 0) {
+         int v = callVertex[depth - 1];
+         EdgeNode* edge = callEdge[depth - 1];
+
+         if (edge != nullptr) {
+            callEdge[depth - 1] = edge->nextEdge;
+            int u = edge->adjVertex;
+            if (order[u] == 0) { // descend
+               order[u] = low[u] = ++discovered;
+               stack[stackSize++] = u;
+               onStack[u] = true;
+               callVertex[depth] = u;
+               callEdge[depth++] = vertices[u].edgeHead.load();
+            }
+            else if (onStack[u] && order[u] < low[v]) {
+               low[v] = order[u];
+            }
+            continue;
+         }
+
+         // every edge of v is explored: close its component if it is a root
+         if (low[v] == order[v]) {
+            // components are closed sinks first, so every component this
+            // one leads to already has its final reach set
+            bitset<MAX_VERTICES>& reaches = index->reaches[components];
+            reaches.reset();
+            int top = stackSize;
+            do {
+               int w = stack[--stackSize];
+               onStack[w] = false;
+               index->component[w] = components;
+               reaches[w] = true;
+            } while (stack[stackSize] != v);
+
+            for (int s = stackSize; s < top; s++) {
+               for (EdgeNode* e = vertices[stack[s]].edgeHead.load(); e != nullptr; e = e->nextEdge) {
+                  int target = index->component[e->adjVertex];
+                  if (target != components) {
+                     reaches |= index->reaches[target];
+                  }
                }
             }
+            components++;
          }
 
-         if (v < 0) {
-            break;
+         depth--;
+         if (depth > 0) {
+            int parent = callVertex[depth - 1];
+            if (low[v] < low[parent]) {
+               low[parent] = low[v];
+            }
          }
+      }
+   }
+
+   return index;
+}
+
+//-------------------------------- stillReaches ---------------------------------
+// Searches the current edges for a path from src to dst
+// Preconditions:  writeLock is held
+// Postconditions: Returns true if dst can be reached from src
+template <typename VertexId, typename Weight>
+bool BasicGraph<VertexId, Weight>::stillReaches(int src, int dst) const {
+   int queue[MAX_VERTICES];
+   int head = 0, tail = 0;
+   bitset<MAX_VERTICES> seen;
+
+   queue[tail++] = src;
+   seen[src] = true;
+   while (head < tail) {
+      int v = queue[head++];
+      if (v == dst) {
+         return true;
+      }
+      for (EdgeNode* curr = vertices[v].edgeHead.load(); curr != nullptr; curr = curr->nextEdge) {
+         if (!seen[curr->adjVertex]) {
+            seen[curr->adjVertex] = true;
+            queue[tail++] = curr->adjVertex;
+         }
+      }
+   }
+   return false;
+}
+
+//-------------------------------- publishReach ---------------------------------
+// Replaces the reachability index and retires the old one
+// Preconditions:  writeLock is held or no other thread uses the graph
+// Postconditions: reach is index and the old index is freed once unseen
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::publishReach(ReachIndex* index) {
+   ReachIndex* old = reach.exchange(index);
+   if (old != nullptr) {
+      epochs.retire(old, deleteReach);
+   }
+}
+
+//-------------------------------- deleteReach ---------------------------------
+// Frees a reachability index; used as the epoch reclamation deleter
+// Preconditions:  No reader can still reach the index
+// Postconditions: The index has been deleted
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::deleteReach(void* index) {
+   delete static_cast<ReachIndex*>(index);
+}
+
+//-------------------------------- snapshotEdges ---------------------------------
+// Copies the published edge lists into flat arrays
+// Preconditions:  The calling thread is pinned in epochs
+// Postconditions: edges holds every edge of vertices 1..size, none masked
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::snapshotEdges(EdgeArrays& edges) const {
+   edges.first.assign(size + 2, 0);
+   edges.target.clear();
+   edges.weight.clear();
+
+   for (int v = 1; v <= size; v++) {
+      edges.first[v] = static_cast<int>(edges.target.size());
+      for (EdgeNode* curr = vertices[v].edgeHead.load(); curr != nullptr; curr = curr->nextEdge) {
+         edges.target.push_back(curr->adjVertex);
+         edges.weight.push_back(curr->weight);
+      }
+   }
+   edges.first[size + 1] = static_cast<int>(edges.target.size());
+   edges.masked.assign(edges.target.size(), false);
+}
 
-         T[i][v].visited = true;
+//-------------------------------- findEdge ---------------------------------
+// Returns the index of the edge from u to v in flat arrays
+// Preconditions:  edges was filled by snapshotEdges
+// Postconditions: Returns the edge index, or -1 if there is no such edge
+template <typename VertexId, typename Weight>
+int BasicGraph<VertexId, Weight>::findEdge(const EdgeArrays& edges, int u, int v) const {
+   for (int e = edges.first[u]; e < edges.first[u + 1]; e++) {
+      if (edges.target[e] == v) {
+         return e;
+      }
+   }
+   return -1;
+}
 
-         // iterate the adjus
-         VertexNode node = vertices[v];
-         EdgeNode* curr = node.edgeHead;
+//-------------------------------- treeToTarget ---------------------------------
+// Builds the shortest path tree of every vertex into dst
+// Preconditions:  edges was filled by snapshotEdges and dst is valid
+// Postconditions: toDst[v] is the distance from v to dst (infinity if none)
+//                 and next[v] is the vertex after v on that path
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::treeToTarget(const EdgeArrays& edges, int dst,
+   vector<Weight>& toDst, vector<int>& next) const {
+   // reverse the edges so that Dijkstra from dst follows them backwards
+   vector<int> firstIn(size + 2, 0);
+   for (size_t e = 0; e < edges.target.size(); e++) {
+      firstIn[edges.target[e] + 1]++;
+   }
+   for (int v = 1; v <= size + 1; v++) {
+      firstIn[v] += firstIn[v - 1];
+   }
+   vector<int> slot(firstIn.begin(), firstIn.end() - 1);
+   vector<int> source(edges.target.size());
+   vector<int> edgeIn(edges.target.size());
+   for (int u = 1; u <= size; u++) {
+      for (int e = edges.first[u]; e < edges.first[u + 1]; e++) {
+         source[slot[edges.target[e]]] = u;
+         edgeIn[slot[edges.target[e]]++] = e;
+      }
+   }
 
-         while (curr != nullptr) {
-            int u = curr->adjVertex;
-            int weight = curr->weight;
+   toDst.assign(size + 1, WeightTraits<Weight>::infinity());
+   next.assign(size + 1, -1);
+   vector<bool> done(size + 1, false);
+   HeapQueue<Weight> queue;
 
-            if (T[i][v].dist + weight < T[i][u].dist && !T[i][u].visited) {
-               T[i][u].dist = T[i][v].dist + weight;
-               T[i][u].path = v;               
-            }            
-            curr = curr->nextEdge;
+   toDst[dst] = 0;
+   queue.push(0, dst);
+   while (!queue.empty()) {
+      Weight key = 0;
+      int v = queue.pop(key);
+      if (done[v] || key > toDst[v]) {
+         continue;
+      }
+      done[v] = true;
+
+      for (int r = firstIn[v]; r < firstIn[v + 1]; r++) {
+         int u = source[r];
+         Weight dist = WeightTraits<Weight>::add(toDst[v], edges.weight[edgeIn[r]]);
+         if (dist < toDst[u] && !done[u]) {
+            toDst[u] = dist;
+            next[u] = v;
+            queue.push(dist, u);
          }
       }
    }
 }
 
+//-------------------------------- spurPath ---------------------------------
+// Finds a shortest path from spur to dst avoiding masked edges and banned vertices
+// Preconditions:  toDst and next were built by treeToTarget for dst
+// Postconditions: Returns true and stores the path in path if one exists
+template <typename VertexId, typename Weight>
+bool BasicGraph<VertexId, Weight>::spurPath(const EdgeArrays& edges, int spur, int dst,
+   const vector<bool>& banned, const vector<Weight>& toDst, const vector<int>& next,
+   Path& path) const {
+   const Weight infinity = WeightTraits<Weight>::infinity();
+   if (toDst[spur] == infinity) {
+      return false;
+   }
+
+   // masking only removes edges, so the unmasked tree path is optimal
+   // whenever it survives the mask
+   path.vertices.assign(1, spur);
+   path.cost = toDst[spur];
+   bool treeUsable = true;
+   for (int v = spur; v != dst && treeUsable; v = next[v]) {
+      int e = findEdge(edges, v, next[v]);
+      treeUsable = !edges.masked[e] && !banned[next[v]];
+      path.vertices.push_back(next[v]);
+   }
+   if (treeUsable) {
+      return true;
+   }
+
+   // A* with the tree distances as a consistent lower bound
+   vector<Weight> dist(size + 1, infinity);
+   vector<int> previous(size + 1, -1);
+   vector<bool> done(size + 1, false);
+   HeapQueue<Weight> queue;
+
+   dist[spur] = 0;
+   queue.push(toDst[spur], spur);
+   while (!queue.empty()) {
+      Weight key = 0;
+      int v = queue.pop(key);
+      if (done[v]) {
+         continue;
+      }
+      done[v] = true;
+      if (v == dst) {
+         break;
+      }
+
+      for (int e = edges.first[v]; e < edges.first[v + 1]; e++) {
+         int u = edges.target[e];
+         if (edges.masked[e] || banned[u] || done[u] || toDst[u] == infinity) {
+            continue;
+         }
+         Weight candidate = WeightTraits<Weight>::add(dist[v], edges.weight[e]);
+         if (candidate < dist[u]) {
+            dist[u] = candidate;
+            previous[u] = v;
+            queue.push(WeightTraits<Weight>::add(candidate, toDst[u]), u);
+         }
+      }
+   }
+
+   if (!done[dst]) {
+      return false;
+   }
+
+   path.cost = dist[dst];
+   path.vertices.clear();
+   for (int v = dst; v != -1; v = previous[v]) {
+      path.vertices.insert(path.vertices.begin(), v);
+   }
+   return true;
+}
+
+//-------------------------------- entry ---------------------------------
+// Returns the shortest path entry for a source and destination
+// Preconditions:  tableLock is held; src and dst are internal ids
+// Postconditions: Returns the entry from the attached result file, with
+//                 its path translated to an internal id, if there is one;
+//                 otherwise T[src][dst]
+template <typename VertexId, typename Weight>
+typename BasicGraph<VertexId, Weight>::Table BasicGraph<VertexId, Weight>::entry(int src, int dst) const {
+   if (results.isOpen()) {
+      Table stored = static_cast<const Table*>(results.row(toExternal[src]))[toExternal[dst]];
+      stored.path = static_cast<VertexId>(toInternal[stored.path]);
+      return stored;
+   }
+   return T[src][dst];
+}
+
+//-------------------------------- dijkstra ---------------------------------
+// Computes single-source shortest paths into a caller-owned row
+// Preconditions:  The calling thread is pinned in epochs and src is a valid vertex
+// Postconditions: row[1..size] holds the dist, path and visited entries for src
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::dijkstra(int src, Table row[]) const {
+   QueueStrategy strategy = getQueueStrategy();
+   const ReachIndex* index = reach.load();
+   const bitset<MAX_VERTICES>* reachable =
+      index == nullptr ? nullptr : &index->reaches[index->component[src]];
+
+   // a source that reaches nothing needs no search
+   if (reachable != nullptr && reachable->count() == 1) {
+      for (int j = 1; j <= size; j++) {
+         row[j].dist = WeightTraits<Weight>::infinity();
+         row[j].visited = false;
+         row[j].path = NO_VERTEX;
+      }
+      row[src].dist = 0;
+      row[src].visited = true;
+      return;
+   }
+
+   if (strategy == SCAN) {
+      dijkstraScan(src, row, reachable);
+      return;
+   }
+   if constexpr (WeightTraits<Weight>::isInteger) {
+      if (strategy == DIAL) {
+         BucketQueue<Weight> queue(maxWeight.load());
+         dijkstraQueue(src, row, queue);
+         return;
+      }
+      if (strategy == RADIX) {
+         RadixHeap<Weight> queue;
+         dijkstraQueue(src, row, queue);
+         return;
+      }
+   }
+   HeapQueue<Weight> queue;
+   dijkstraQueue(src, row, queue);
+}
+
+//-------------------------------- dijkstraScan ---------------------------------
+// Single-source Dijkstra that scans the row for the next vertex, only over
+// the vertices in reachable when it is given
+// Preconditions:  Same as dijkstra, and reachable is nullptr or holds every
+//                 vertex reachable from src
+// Postconditions: Same as dijkstra
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::dijkstraScan(int src, Table row[],
+   const bitset<MAX_VERTICES>* reachable) const {
+   int scan[MAX_VERTICES]; // vertices the minimum is searched over
+   int scanned = 0;
+   bitset<MAX_VERTICES> inScan;
+
+   for (int j = 1; j <= size; j++) {
+      row[j].dist = WeightTraits<Weight>::infinity();
+      row[j].visited = false;
+      row[j].path = NO_VERTEX;
+
+      if (reachable == nullptr || (*reachable)[j]) {
+         scan[scanned++] = j;
+         inScan[j] = true;
+      }
+   }
+
+   row[src].dist = 0;
+
+   int v = 0;  // smallest vertex
+
+   while (true) {
+      v = -1;
+      Weight min_dist = WeightTraits<Weight>::infinity();
+
+      // pick the vertex with the smallest distance in visited node
+      for (int s = 0; s < scanned; s++) {
+         int j = scan[s];
+         if (row[j].visited == false) {
+            if (row[j].dist < min_dist) {
+               min_dist = row[j].dist;
+               v = j;
+            }
+         }
+      }
+
+      if (v < 0) {
+         break;
+      }
+
+      row[v].visited = true;
+
+      // iterate the adjacent vertices of the published list
+      EdgeNode* curr = vertices[v].edgeHead.load();
+
+      while (curr != nullptr) {
+         int u = curr->adjVertex;
+         Weight weight = curr->weight;
+
+         Weight dist = WeightTraits<Weight>::add(row[v].dist, weight);
+
+         if (dist < row[u].dist && !row[u].visited) {
+            row[u].dist = dist;
+            row[u].path = static_cast<VertexId>(v);
+
+            // an edge published after the index was loaded can reach further
+            if (!inScan[u]) {
+               scan[scanned++] = u;
+               inScan[u] = true;
+            }
+         }
+         curr = curr->nextEdge;
+      }
+   }
+}
+
+//-------------------------------- dijkstraQueue ---------------------------------
+// Single-source Dijkstra driven by a priority queue with lazy deletion
+// Preconditions:  Same as dijkstra, and queue is empty
+// Postconditions: Same as dijkstra
+template <typename VertexId, typename Weight>
+template <typename Queue>
+void BasicGraph<VertexId, Weight>::dijkstraQueue(int src, Table row[], Queue& queue) const {
+   for (int j = 1; j <= size; j++) {
+      row[j].dist = WeightTraits<Weight>::infinity();
+      row[j].visited = false;
+      row[j].path = NO_VERTEX;
+   }
+
+   row[src].dist = 0;
+   queue.push(0, src);
+
+   while (!queue.empty()) {
+      Weight key = 0;
+      int v = queue.pop(key);
+
+      // skip entries superseded by a shorter distance
+      if (row[v].visited || key > row[v].dist) {
+         continue;
+      }
+
+      row[v].visited = true;
+
+      EdgeNode* curr = vertices[v].edgeHead.load();
+
+      while (curr != nullptr) {
+         int u = curr->adjVertex;
+         Weight weight = curr->weight;
+
+         Weight dist = WeightTraits<Weight>::add(row[v].dist, weight);
+
+         if (dist < row[u].dist && !row[u].visited) {
+            row[u].dist = dist;
+            row[u].path = static_cast<VertexId>(v);
+            queue.push(row[u].dist, u);
+         }
+         curr = curr->nextEdge;
+      }
+   }
+}
+
+//-------------------------------- publishEdges ---------------------------------
+// Replaces the edge list of a vertex and retires the old one
+// Preconditions:  writeLock is held
+// Postconditions: vertices[v].edgeHead is newHead, the old list is freed once
+//                 no reader can see it and the version is incremented
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::publishEdges(int v, EdgeNode* newHead) {
+   EdgeNode* oldHead = vertices[v].edgeHead.exchange(newHead);
+   version.fetch_add(1);
+
+   if (oldHead != nullptr) {
+      epochs.retire(oldHead, deleteEdges);
+   }
+}
+
+//-------------------------------- deleteEdges ---------------------------------
+// Frees a whole edge list; used as the epoch reclamation deleter
+// Preconditions:  No reader can still reach the list
+// Postconditions: Every node of the list has been deleted
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::deleteEdges(void* head) {
+   EdgeNode* curr = static_cast<EdgeNode*>(head);
+
+   while (curr != nullptr) {
+      EdgeNode* next = curr->nextEdge;
+      delete curr;
+      curr = next;
+   }
+}
+
 //------------------------------- displayAll -------------------------------
 // Displays the shortest paths between all vertices in the graph
 // Preconditions:  The graph is not empty and the T matrix has been populated
 //                 with the shortest path data
 // Postconditions: The shortest paths between all vertices in the graph have
 //                 been displayed on the console
-void Graph::displayAll() {
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::displayAll() {
+   lock_guard<mutex> lock(tableLock);
    cout << "Shortest paths between all vertices:" << endl;
    cout << setw(30) << left << "Description" << setw(6) << left << "From" << setw(6) << left << "To" << setw(6) << left << "Dist" << "Path" << endl;
    for (int i = 1; i <= size; i++) {
-      cout << vertices[i].data->getDescription() << endl;
+      cout << vertices[toInternal[i]].data->getDescription() << endl;
       for (int j = 1; j <= size; j++) {
          if (i == j) {
             continue;
          }
 
          cout << setw(30) << left << "" << setw(6) << left << i << setw(6) << left << j;
-         if (T[i][j].visited) {
-            cout << setw(6) << left << T[i][j].dist;
+         if (entry(toInternal[i], toInternal[j]).visited) {
+            cout << distColumn(entry(toInternal[i], toInternal[j]).dist);
             // generate path
-            string path = calcPath(i, j);
+            string path = calcPath(toInternal[i], toInternal[j]);
           
             cout << path;
          }
@@ -298,10 +1444,14 @@ void Graph::displayAll() {
 // Postconditions: The shortest path from the source vertex to the destination
 //                 vertex, including the total cost and the list of vertices
 //                 visited along the way, is displayed on the console.
-void Graph::display(int src, int dst) {
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::display(int src, int dst) {
+   lock_guard<mutex> lock(tableLock);
    cout << setw(6) << left << src << setw(6) << left << dst;
-   if (T[src][dst].visited) {
-      cout << setw(6) << left << T[src][dst].dist;
+   src = toInternal[src];
+   dst = toInternal[dst];
+   if (entry(src, dst).visited) {
+      cout << distColumn(entry(src, dst).dist);
 
       string path = calcPath(src, dst);
       string visited_vertices = getVerticesName(src, dst);
@@ -317,18 +1467,34 @@ void Graph::display(int src, int dst) {
    }
 }
 
+//-------------------------------- distColumn ---------------------------------
+// Formats a distance for the Dist column of displayAll and display
+// Preconditions:  None
+// Postconditions: Returns dist padded to 6 characters; a wider distance is
+//                 followed by one space so that it stays apart from the path
+template <typename VertexId, typename Weight>
+string BasicGraph<VertexId, Weight>::distColumn(Weight dist) const {
+   ostringstream text;
+   text << dist;
+   string column = text.str();
+   column.append(column.size() < 6 ? 6 - column.size() : 1, ' ');
+   return column;
+}
+
 //-------------------------------- calcPath ---------------------------------
 // Helper method to get the path from the source vertex to the destination vertex
 // Preconditions: The graph must be initialized with vertices and edges, and the 
 //                `findShortestPath` method must have been executed.
+//                src and dst are internal ids.
 // Postconditions: Returns a string representation of the path from the source vertex 
-//                 to the destination vertex, represented as a sequence of vertex IDs separated by spaces.
-string Graph::calcPath(int src, int dst) {
-   if (T[src][dst].path < 0) {
-      return to_string(dst);
+//                 to the destination vertex, represented as a sequence of external vertex IDs separated by spaces.
+template <typename VertexId, typename Weight>
+string BasicGraph<VertexId, Weight>::calcPath(int src, int dst) {
+   if (entry(src, dst).path == NO_VERTEX) {
+      return to_string(toExternal[dst]);
    }
 
-   return calcPath(src, T[src][dst].path) + " " + to_string(dst);
+   return calcPath(src, entry(src, dst).path) + " " + to_string(toExternal[dst]);
 }
 
 //-------------------------------- getVerticesName ------------------------------
@@ -338,48 +1504,55 @@ string Graph::calcPath(int src, int dst) {
 //                The vertices have descriptions.
 // Postconditions: The method returns the description of the shortest path from 
 //                 the source vertex to the destination vertex.
-string Graph::getVerticesName(int src, int dst) {
+template <typename VertexId, typename Weight>
+string BasicGraph<VertexId, Weight>::getVerticesName(int src, int dst) {
    string desc = vertices[dst].data->getDescription();
-   if (T[src][dst].path < 0) {
+   if (entry(src, dst).path == NO_VERTEX) {
       return desc;
    }
 
-   return getVerticesName(src, T[src][dst].path) + "\n" + desc;
+   return getVerticesName(src, entry(src, dst).path) + "\n" + desc;
 }
 
 //-------------------------------- clear ---------------------------------
 // Clears the graph of all vertices and edges
 // Preconditions:  The graph object must be initialized
 // Postconditions: The graph object will be cleared of all vertices and edges, and its size will be reset to 0. All dynamically allocated memory will be freed.
-void Graph::clear() {
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::clear() {
    for (int v = 1; v <= size; v++) {
       if (vertices[v].data != nullptr) {
          delete vertices[v].data;
          vertices[v].data = nullptr;
       }
 
-      if (vertices[v].edgeHead != nullptr) {
-         EdgeNode* curr = vertices[v].edgeHead;
-
-         while (curr != nullptr) {
-            EdgeNode* next = curr->nextEdge;
-            delete curr;
-            curr = next;
-         }
-
-         vertices[v].edgeHead = nullptr;
+      if (vertices[v].edgeHead.load() != nullptr) {
+         deleteEdges(vertices[v].edgeHead.load());
+         vertices[v].edgeHead.store(nullptr);
       }
    }
    size = 0;
+   maxWeight.store(0);
+   results.close();
+   delete reach.exchange(nullptr);
+   resetIds();
+   epochs.reclaim();
 }
 
 // --------------------------------copy-------------------------------- -
 // Copies the data from a given Graph object into the current Graph object.
 // Preconditions: The input Graph object must be properly initialized with vertices and edges.
 // Postconditions: The current Graph object is initialized with the same vertices and edges as the input Graph object.
-void Graph::copy(const Graph& g) {
+template <typename VertexId, typename Weight>
+void BasicGraph<VertexId, Weight>::copy(const BasicGraph& g) {
    // copy vertices data
    size = g.size;
+   maxWeight.store(g.maxWeight.load());
+   queueStrategy.store(g.queueStrategy.load());
+   for (int v = 0; v < MAX_VERTICES; v++) { // keep the same internal layout
+      toInternal[v] = g.toInternal[v];
+      toExternal[v] = g.toExternal[v];
+   }
    for (int v = 1; v <= g.size; v++) {
       if (g.vertices[v].data != nullptr) {
          vertices[v].data = new Vertex(g.vertices[v].data->getDescription());
@@ -388,8 +1561,8 @@ void Graph::copy(const Graph& g) {
    }
 
    // copy edges data
-   for (int v = 1; v < g.size; v++) {
-      EdgeNode* currg = g.vertices[v].edgeHead;
+   for (int v = 1; v <= g.size; v++) {
+      EdgeNode* currg = g.vertices[v].edgeHead.load();
       EdgeNode* curr = nullptr;
 
       while (currg != nullptr) {
@@ -400,7 +1573,7 @@ void Graph::copy(const Graph& g) {
 
          if (curr == nullptr) {
             // create head
-            vertices[v].edgeHead = newEdge;
+            vertices[v].edgeHead.store(newEdge);
          }
          else {
             curr->nextEdge = newEdge;
@@ -410,4 +1583,17 @@ void Graph::copy(const Graph& g) {
          currg = currg->nextEdge;
       }
    }
-}
\ No newline at end of file
+
+   if (g.reach.load() != nullptr) {
+      reach.store(buildReach());
+   }
+}
+
+template class BasicGraph<uint16_t, uint16_t>;
+template class BasicGraph<uint16_t, int32_t>;
+template class BasicGraph<uint16_t, int64_t>;
+template class BasicGraph<uint16_t, double>;
+template class BasicGraph<uint32_t, uint16_t>;
+template class BasicGraph<uint32_t, int32_t>;
+template class BasicGraph<uint32_t, int64_t>;
+template class BasicGraph<uint32_t, double>;
@@ -1,11 +1,23 @@
 //--------------------------------------------------------------------
 // GRAPH.H
-// Declaration and definition of the Graph class
+// Declaration and definition of the BasicGraph class template
 // Author: [Your Name]
 //--------------------------------------------------------------------
-// Graph class:
-//   Implements a graph data structure and various graph algorithms
-//   using the following methods:
+// BasicGraph<VertexId, Weight> class template:
+//   Implements a graph data structure and various graph algorithms.
+//   VertexId is the unsigned type stored for adjacent and previous
+//   vertices (uint16_t or uint32_t) and Weight is the type of edge
+//   weights and path distances (uint16_t, int32_t, int64_t or double).
+//   Narrow types shrink EdgeNode and Table; wide types keep long paths
+//   from overflowing. Graph is the <uint16_t, int32_t> specialization
+//   that matches the original int-based class for up to 100 vertices.
+//   MAX_VERTICES stays at 101 for every VertexId, because vertices[] and
+//   the MAX_VERTICES x MAX_VERTICES table T are fixed arrays. A uint32_t
+//   id therefore adds no capacity. The uint32_t instantiations keep the
+//   wide id path compiled and tested, so that supporting larger graphs
+//   only takes a larger MAX_VERTICES (and memory for a table that grows
+//   with its square).
+//   Uses the following methods:
 //      Graph - constructor that initializes an empty graph
 //      ~Graph - destructor that deallocates memory used by the graph
 //      insertEdge - adds an edge to the graph
@@ -13,51 +25,128 @@
 //      printEdges - displays all edges in the graph
 //      printVertices - displays all vertices in the graph
 //      displayAll - displays the shortest path between all vertices in the graph
+//      getVersion - returns the number of published edge updates
+//      setQueueStrategy - selects the priority queue used by findShortestPath
+//      findShortestPathSharded - runs findShortestPath across worker processes
+//                                into a memory-mapped result file
+//      attachResults - displays shortest paths from a result file
+//      kShortestPaths - returns the k shortest loopless paths between two vertices
+//      findShortestPathFrom - returns single-source shortest paths without
+//                             touching the table
+//      isReachable - answers in O(1) whether any path joins two vertices
+//      getSize - returns the number of vertices
+//      reorderVertices - renumbers the internal layout of the vertices for
+//                        locality while keeping external ids unchanged
+//   Vertex ids:
+//      - Every public method takes and returns the ids of the input file.
+//        Internally, vertices[], the edge lists and T are indexed by an
+//        internal id that reorderVertices may permute;
+//        toInternal and toExternal translate at the public methods, so
+//        Dijkstra itself never translates.
+//      - Result files hold rows, entries and path vertices by external id,
+//        so they do not depend on the layout of the graph that wrote them.
+//   Concurrency:
+//      - Any number of threads may call findShortestPath, printEdges,
+//        displayAll and display while other threads call insertEdge and
+//        removeEdge. Each edge list is immutable once published; an edge
+//        update builds a new list and publishes it atomically, and the
+//        old list is freed through epoch-based reclamation once no reader
+//        can still be walking it.
+//      - buildGraph, operator=, copying, destruction, reorderVertices and
+//        findShortestPathSharded must not run concurrently with any other
+//        method
 //   Assumptions:
 //      - The insertEdge method assumes that the src and dst vertex numbers are valid
 //      - The removeEdge method assumes that the edge to be removed exists in the graph
 //      - The input to the displayAll method should result in a connected graph
+//      - Weights are non-negative. With an integer Weight, a distance that
+//        would reach numeric_limits<Weight>::max() saturates and the
+//        destination is reported as unreachable.
 //--------------------------------------------------------------------
 
 #pragma once
+#include <atomic>
+#include <bitset>
+#include <cstdint>
 #include <fstream>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include "Epoch.h"
+#include "Queues.h"
+#include "ResultFile.h"
 #include "Vertex.h"
+#include "Weights.h"
 
 using namespace std;
 
-class Graph {
+template <typename VertexId, typename Weight>
+class BasicGraph {
+   static_assert(is_integral<VertexId>::value && is_unsigned<VertexId>::value,
+      "vertex ids must be unsigned integers");
+
 public:
+   // priority queue used to pick the next vertex in Dijkstra's algorithm
+   enum QueueStrategy {
+      AUTO, // DIAL or RADIX, chosen from the largest edge weight seen;
+            // BINARY_HEAP for floating point weights
+      SCAN, // linear scan of the table row, O(n^2) per source
+      BINARY_HEAP, // HeapQueue
+      DIAL, // BucketQueue with one bucket per weight up to the largest
+      RADIX // RadixHeap
+   };
+
+   // internal layout chosen by reorderVertices
+   enum VertexOrder {
+      INPUT, // the order of the input file
+      BFS, // breadth-first from the lowest id, neighbours by id
+      REVERSE_CUTHILL_MCKEE, // breadth-first from a lowest degree vertex,
+                             // neighbours by degree, then reversed
+      DEGREE // most edges first, so hub rows and columns sit together
+   };
+
+   // run by each worker process of findShortestPathSharded before it starts
+   // its range; attempt counts from 1. Lets a test make workers fail or hang.
+   typedef void (*ShardHook)(int shard, int attempt);
+
+   // one path returned by kShortestPaths
+   struct Path {
+      Weight cost; // total weight of the path
+      vector<int> vertices; // src first, dst last
+   };
+
    //--------------------------------- Graph -------------------------------------
    // Graph constructor
    // Preconditions: None
    // Postconditions: A graph object is created and initialized with the following:
    //    - All vertices set to nullptr
    //    - All edges set to nullptr
-   //    - T[i][j].dist set to INT_MAX for all i and j
+   //    - T[i][j].dist set to infinity for all i and j
    //    - T[i][j].visited set to false for all i and j
-   //    - T[i][j].path set to -1 for all i and j
+   //    - T[i][j].path set to NO_VERTEX for all i and j
    //    - C[i][j] set to 0 for all i and j
    //    - size set to 0
-   Graph(); // constructor
+   BasicGraph(); // constructor
 
    //------------------------------ Graph(const Graph& g) ------------------------------
    // Constructs a copy of a graph object
    // Preconditions: The graph object g is initialized
    // Postconditions: A new graph object is created with the same values as the original graph object g
-   Graph(const Graph& g); // copy constructor
+   BasicGraph(const BasicGraph& g); // copy constructor
 
    //---------------------------------- ~Graph -----------------------------------
    // Destructor for the Graph class
    // Preconditions:  Graph object has been created
    // Postconditions: Graph object's memory is deallocated and its resources are freed
-   ~Graph(); // destructor
+   ~BasicGraph(); // destructor
 
    //------------------------------- operator= ----------------------------------
    // Overloads the assignment operator to copy one graph to another graph object
    // Preconditions:  The graph object must be properly initialized.
    // Postconditions: The graph object is copied from the input graph object, including
    //                 all vertices and edges. The previous data in the graph object is deleted.
-   Graph& operator=(const Graph& g); // assign operator
+   BasicGraph& operator=(const BasicGraph& g); // assign operator
 
    //-------------------------------- buildGraph ---------------------------------
    // Builds a graph by reading data from an ifstream
@@ -86,6 +175,34 @@ public:
    //                where T[i][j] represents the cost of the shortest path from vertex i to vertex j.
    void findShortestPath();
 
+   //----------------------------- findShortestPathSharded ------------------------------
+   // Calculates the same table as findShortestPath with the sources split across
+   // worker processes. Each worker is forked with a read-only view of the graph
+   // and writes its rows, by external id, straight into a shared memory-mapped
+   // file at path. The
+   // calling process assigns contiguous source ranges, waits for the workers, and
+   // reruns the range of a worker that crashed, left rows unfinished, or was
+   // still running deadlineMs after it started (it is then killed), up to
+   // SHARD_ATTEMPTS times per range. workerStart, if given, runs in each worker.
+   // Preconditions:  The graph is initialized, workers >= 1, deadlineMs > 0, and
+   //                 no other thread is using the graph (a forked worker only has
+   //                 the calling thread)
+   // Postconditions: Returns true if every row was written; path is then attached
+   //                 as by attachResults. Returns false if the file cannot be
+   //                 created or a range fails every attempt. Any previously
+   //                 attached file is detached first.
+   bool findShortestPathSharded(const char* path, int workers,
+      int deadlineMs = SHARD_DEADLINE_MS, ShardHook workerStart = nullptr);
+
+   //--------------------------------- attachResults ----------------------------------
+   // Maps a result file written by findShortestPathSharded for display
+   // Preconditions:  path was written for a graph with the same vertices and edges
+   // Postconditions: Returns true if path holds a complete table of this graph's
+   //                 size and type; displayAll and display then read it instead of
+   //                 the in-memory table until the next findShortestPath call.
+   //                 Returns false and leaves the display source unchanged otherwise.
+   bool attachResults(const char* path);
+
    //------------------------------- displayAll -------------------------------
    // Displays the shortest paths between all vertices in the graph
    // Preconditions:  The graph is not empty and the T matrix has been populated
@@ -110,26 +227,113 @@ public:
    // Inserts an edge between two vertices of the graph
    // Preconditions:  The graph has been initialized with vertices, and `src` and `dest` are valid vertices in the graph.
    // Postconditions: An edge is inserted between the vertices `src` and `dest` with a weight of `weight`.
-   void insertEdge(int src, int dest, int weight);
+   void insertEdge(int src, int dest, Weight weight);
 
    //-------------------------------- removeEdge ---------------------------------
    // Removes an edge from the graph
    // Preconditions:  src and dst vertices must exist in the graph
    //                 and have an edge between them
-   // Postconditions: The edge between src and dst vertices is removed from the graph
+   // Postconditions: The edge between src and dst vertices is removed from the graph.
+   //                 Keeping the reachability index costs one O(V + E) search
+   //                 for another path from src to dst, and a rebuild (O(V + E)
+   //                 plus one bitset union per edge) only if there is none.
    void removeEdge(int src, int dest);
 
+   //-------------------------------- getVersion ---------------------------------
+   // Returns the number of edge updates published since the graph was built
+   // Preconditions:  None
+   // Postconditions: Returns the current adjacency version
+   unsigned long getVersion() const;
+
+   //----------------------------- setQueueStrategy ------------------------------
+   // Selects the priority queue used by findShortestPath
+   // Preconditions:  None
+   // Postconditions: Subsequent shortest path runs use strategy. AUTO uses DIAL
+   //                 while the largest edge weight inserted so far is at most
+   //                 DIAL_MAX_WEIGHT, and RADIX otherwise. DIAL and RADIX
+   //                 fall back to BINARY_HEAP for floating point weights.
+   void setQueueStrategy(QueueStrategy strategy);
+
+   //----------------------------- getQueueStrategy ------------------------------
+   // Returns the queue findShortestPath will use
+   // Preconditions:  None
+   // Postconditions: Returns the selected strategy with AUTO resolved
+   QueueStrategy getQueueStrategy() const;
+
+   //-------------------------------- kShortestPaths ---------------------------------
+   // Finds up to k shortest loopless paths from src to dst using Yen's algorithm
+   // Preconditions:  src and dst are valid vertices and k >= 0. May run concurrently
+   //                 with edge updates; it then answers for one set of edge lists.
+   // Postconditions: Returns the paths in order of nondecreasing cost, with no
+   //                 vertex repeated within a path; fewer than k if no more exist.
+   //                 The graph is not modified: spur searches mask edges in a
+   //                 private copy of the adjacency lists, and reuse the shortest
+   //                 path tree into dst both as an A* bound and, when it avoids
+   //                 every masked edge, as the spur path itself.
+   vector<Path> kShortestPaths(int src, int dst, int k) const;
+
+   //----------------------------- findShortestPathFrom ------------------------------
+   // Calculates the shortest paths from one source into caller-owned vectors
+   // Preconditions:  May run concurrently with edge updates and other queries
+   // Postconditions: Returns false if src is not a vertex. Otherwise returns true,
+   //                 dist[v] is the cost from src to v (WeightTraits<Weight>::infinity()
+   //                 if unreachable) and path[v] is the vertex before v on that path
+   //                 (0 for src and unreachable vertices), for v in 1..size.
+   //                 The table used by displayAll is not changed.
+   bool findShortestPathFrom(int src, vector<Weight>& dist, vector<int>& path) const;
+
+   //-------------------------------- isReachable ---------------------------------
+   // Returns whether some path leads from src to dst, using the reachability
+   // index of strongly connected components built with the graph
+   // Preconditions:  May run concurrently with edge updates
+   // Postconditions: Returns false if src or dst is not a vertex or dst is
+   //                 provably unreachable from src; true otherwise
+   bool isReachable(int src, int dst) const;
+
+   //---------------------------------- getSize -----------------------------------
+   // Returns the number of vertices in the graph
+   // Preconditions:  None
+   // Postconditions: Returns size
+   int getSize() const;
+
+   //------------------------------- reorderVertices -------------------------------
+   // Renumbers the internal layout so that vertices that share edges sit close
+   // together in vertices[] and in the rows of T. The orders treat edges as
+   // undirected and work from external ids, so the layout depends only on the
+   // graph and the order, not on earlier reorderings.
+   // Preconditions:  The graph is built and no other thread is using it
+   // Postconditions: vertices[], the edge lists and T are permuted into order,
+   //                 and every public method still uses the input file's ids.
+   //                 Distances are unchanged; where equal cost paths tie, later
+   //                 runs may report a different one. An attached result file
+   //                 is detached because its rows follow the old layout.
+   void reorderVertices(VertexOrder order);
+
 private:
-   static const int MAX_VERTICES = 101;
+   static const int MAX_VERTICES = 101; // same for every VertexId; see above
+   // largest weight for which AUTO picks Dial's buckets; beyond this the
+   // empty buckets between distances cost more than radix redistribution
+   static const int DIAL_MAX_WEIGHT = 255;
+   // path entry of a vertex with no predecessor; vertex ids start at 1
+   static const VertexId NO_VERTEX = 0;
+   // sharded runs split the sources into this many ranges per worker so that
+   // a failed worker only costs a small range
+   static const int SHARDS_PER_WORKER = 4;
+   static const int SHARD_ATTEMPTS = 3; // runs of a range before giving up
+   // default time a worker may take for its range before it counts as hung
+   static const int SHARD_DEADLINE_MS = 10000;
+
+   static_assert(numeric_limits<VertexId>::max() >= MAX_VERTICES,
+      "VertexId cannot index every vertex");
 
    struct EdgeNode { // can change to a class, if desired
-      int adjVertex; // subscript of the adjacent vertex 
-      int weight; // weight of edge
+      VertexId adjVertex; // subscript of the adjacent vertex 
+      Weight weight; // weight of edge
       EdgeNode* nextEdge;
    };
 
    struct VertexNode {
-      EdgeNode* edgeHead; // head of the list of edges
+      atomic<EdgeNode*> edgeHead; // head of the list of edges, replaced whole on update
       Vertex* data; // store vertex data here
    };
 
@@ -138,8 +342,8 @@ private:
    // table of information for Dijkstra's algorithm
    struct Table {
       bool visited; // whether vertex has been visited
-      int dist; // shortest known distance from source
-      int path; // previous vertex in path of min dist
+      Weight dist; // shortest known distance from source
+      VertexId path; // previous vertex in path of min dist
    };
 
    int size; // number of vertices in the graph
@@ -148,12 +352,173 @@ private:
    // two dimensional in order to solve
    // for all sources
 
+   mutable EpochManager epochs; // reclaims edge lists replaced by updates
+   mutex writeLock; // serializes insertEdge and removeEdge
+   mutable mutex tableLock; // guards rows of T while they are published or read
+   atomic<unsigned long> version; // number of published edge updates
+   atomic<Weight> maxWeight; // largest weight passed to insertEdge since the graph was built
+   atomic<QueueStrategy> queueStrategy; // selected by setQueueStrategy
+   ResultFile results; // attached result file, read instead of T while open
+
+   // strongly connected components and the vertices each one reaches,
+   // rebuilt by the writer and published like the edge lists
+   struct ReachIndex {
+      int component[MAX_VERTICES]; // component of each vertex
+      bitset<MAX_VERTICES> reaches[MAX_VERTICES]; // vertices reachable from each component
+   };
+   // index of the current edges; nullptr while none is built, in which
+   // case every vertex counts as reachable
+   atomic<ReachIndex*> reach;
+
+   // internal id of each input file id and back; entry 0 maps NO_VERTEX
+   // to itself
+   int toInternal[MAX_VERTICES];
+   int toExternal[MAX_VERTICES];
+
+   //-------------------------------- vertexOrder ---------------------------------
+   // Lists the vertices in the order reorderVertices lays them out
+   // Preconditions:  No other thread is changing the edges
+   // Postconditions: Returns every external id 1..size once, first to last
+   vector<int> vertexOrder(VertexOrder order) const;
+
+   //-------------------------------- resetIds ---------------------------------
+   // Makes every internal id equal to its external id
+   // Preconditions:  None
+   // Postconditions: toInternal and toExternal are the identity
+   void resetIds();
+
+   //-------------------------------- buildReach ---------------------------------
+   // Finds the strongly connected components with an iterative Tarjan pass and
+   // the vertices reachable from each one over the condensation DAG
+   // Preconditions:  No other thread is changing the edges
+   // Postconditions: Returns a new index of the current edges
+   ReachIndex* buildReach() const;
+
+   //-------------------------------- stillReaches ---------------------------------
+   // Searches the current edges for a path from src to dst
+   // Preconditions:  writeLock is held
+   // Postconditions: Returns true if dst can be reached from src
+   bool stillReaches(int src, int dst) const;
+
+   //-------------------------------- publishReach ---------------------------------
+   // Replaces the reachability index and retires the old one
+   // Preconditions:  writeLock is held or no other thread uses the graph
+   // Postconditions: reach is index and the old index is freed once unseen
+   void publishReach(ReachIndex* index);
+
+   //-------------------------------- deleteReach ---------------------------------
+   // Frees a reachability index; used as the epoch reclamation deleter
+   // Preconditions:  No reader can still reach the index
+   // Postconditions: The index has been deleted
+   static void deleteReach(void* index);
+
+   // flat copy of the adjacency lists, read once per query so that edges can
+   // be masked without touching the published lists
+   struct EdgeArrays {
+      vector<int> first; // edges of v are first[v] .. first[v + 1] - 1
+      vector<int> target; // adjacent vertex of each edge
+      vector<Weight> weight; // weight of each edge
+      vector<bool> masked; // edges hidden from spur searches
+   };
+
+   //-------------------------------- snapshotEdges ---------------------------------
+   // Copies the published edge lists into flat arrays
+   // Preconditions:  The calling thread is pinned in epochs
+   // Postconditions: edges holds every edge of vertices 1..size, none masked
+   void snapshotEdges(EdgeArrays& edges) const;
+
+   //-------------------------------- findEdge ---------------------------------
+   // Returns the index of the edge from u to v in flat arrays
+   // Preconditions:  edges was filled by snapshotEdges
+   // Postconditions: Returns the edge index, or -1 if there is no such edge
+   int findEdge(const EdgeArrays& edges, int u, int v) const;
+
+   //-------------------------------- treeToTarget ---------------------------------
+   // Builds the shortest path tree of every vertex into dst
+   // Preconditions:  edges was filled by snapshotEdges and dst is valid
+   // Postconditions: toDst[v] is the distance from v to dst (infinity if none)
+   //                 and next[v] is the vertex after v on that path
+   void treeToTarget(const EdgeArrays& edges, int dst, vector<Weight>& toDst,
+      vector<int>& next) const;
+
+   //-------------------------------- spurPath ---------------------------------
+   // Finds a shortest path from spur to dst avoiding masked edges and banned vertices
+   // Preconditions:  toDst and next were built by treeToTarget for dst
+   // Postconditions: Returns true and stores the path in path if one exists
+   bool spurPath(const EdgeArrays& edges, int spur, int dst, const vector<bool>& banned,
+      const vector<Weight>& toDst, const vector<int>& next, Path& path) const;
+
+   //-------------------------------- entry ---------------------------------
+   // Returns the shortest path entry for a source and destination
+   // Preconditions:  tableLock is held; src and dst are internal ids
+   // Postconditions: Returns the entry from the attached result file, with
+   //                 its path translated to an internal id, if there is one;
+   //                 otherwise T[src][dst]
+   Table entry(int src, int dst) const;
+
+   //-------------------------------- tableType ---------------------------------
+   // Returns the entry type tag of Table in result files
+   // Preconditions:  None
+   // Postconditions: Returns a tag built from the sizes of VertexId and Weight
+   //                 and whether Weight is floating point or signed, so that
+   //                 instantiations with equally sized tables differ
+   static uint32_t tableType();
+
+   //-------------------------------- runShard ---------------------------------
+   // Computes a range of rows into a result file; runs in a worker process
+   // Preconditions:  file is mapped for writing and 1 <= first <= last <= size
+   // Postconditions: Rows first..last of external sources are written by
+   //                 external id and marked done
+   void runShard(ResultFile& file, int first, int last) const;
+
+   //-------------------------------- dijkstra ---------------------------------
+   // Computes single-source shortest paths into a caller-owned row
+   // Preconditions:  The calling thread is pinned in epochs and src is a valid vertex
+   // Postconditions: row[1..size] holds the dist, path and visited entries for src
+   void dijkstra(int src, Table row[]) const;
+
+   //-------------------------------- dijkstraScan ---------------------------------
+   // Single-source Dijkstra that scans the row for the next vertex, only over
+   // the vertices in reachable when it is given
+   // Preconditions:  Same as dijkstra, and reachable is nullptr or holds every
+   //                 vertex reachable from src
+   // Postconditions: Same as dijkstra
+   void dijkstraScan(int src, Table row[], const bitset<MAX_VERTICES>* reachable) const;
+
+   //-------------------------------- dijkstraQueue ---------------------------------
+   // Single-source Dijkstra driven by a priority queue with lazy deletion
+   // Preconditions:  Same as dijkstra, and queue is empty
+   // Postconditions: Same as dijkstra
+   template <typename Queue>
+   void dijkstraQueue(int src, Table row[], Queue& queue) const;
+
+   //-------------------------------- publishEdges ---------------------------------
+   // Replaces the edge list of a vertex and retires the old one
+   // Preconditions:  writeLock is held
+   // Postconditions: vertices[v].edgeHead is newHead, the old list is freed once
+   //                 no reader can see it and the version is incremented
+   void publishEdges(int v, EdgeNode* newHead);
+
+   //-------------------------------- deleteEdges ---------------------------------
+   // Frees a whole edge list; used as the epoch reclamation deleter
+   // Preconditions:  No reader can still reach the list
+   // Postconditions: Every node of the list has been deleted
+   static void deleteEdges(void* head);
+
+   //-------------------------------- distColumn ---------------------------------
+   // Formats a distance for the Dist column of displayAll and display
+   // Preconditions:  None
+   // Postconditions: Returns dist padded to 6 characters; a wider distance is
+   //                 followed by one space so that it stays apart from the path
+   string distColumn(Weight dist) const;
+
    //-------------------------------- calcPath ---------------------------------
    // Helper method to get the path from the source vertex to the destination vertex
    // Preconditions: The graph must be initialized with vertices and edges, and the 
    //                `findShortestPath` method must have been executed.
+   //                src and dst are internal ids.
    // Postconditions: Returns a string representation of the path from the source vertex 
-   //                 to the destination vertex, represented as a sequence of vertex IDs separated by spaces.
+   //                 to the destination vertex, represented as a sequence of external vertex IDs separated by spaces.
    string calcPath(int src, int dst);
 
    //-------------------------------- getVerticesName ------------------------------
@@ -175,6 +540,8 @@ private:
    // Copies the data from a given Graph object into the current Graph object.
    // Preconditions: The input Graph object must be properly initialized with vertices and edges.
    // Postconditions: The current Graph object is initialized with the same vertices and edges as the input Graph object.
-   void copy(const Graph& g);
+   void copy(const BasicGraph& g);
 };
 
+typedef BasicGraph<uint16_t, int32_t> Graph;
+
@@ -7,14 +7,250 @@
 // perform Dijkstra's algorithm for CSS 502 Program 3.
 // It is not meant to exhaustively test the class.
 //
+// Usage:
+//   HW3                            runs the tests below
+//   HW3 --serve GRAPH [SOCKET]     loads GRAPH once and answers queries from
+//                                  stdin, or from clients of the Unix socket
+//                                  SOCKET (see QueryService.h)
+//   HW3 --bench [RUNS]             times findShortestPath on generated
+//                                  road-like and power-law graphs in each
+//                                  vertex order, RUNS times each (default 200)
+//
 // Assumptions:
 //   -- a text file named "HW3.txt" exists in the same directory
 //      as the code and is formatted as described in the specifications
 //---------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <iomanip>
+#include <random>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 #include "Graph.h"
+#include "QueryService.h"
 using namespace std;
+
+//-------------------------- shard hooks ------------------------------------
+// Run in the workers of findShortestPathSharded to exercise its retries
+// Preconditions:   Called in a forked worker before it computes its range
+// Postconditions:  The worker exits with a failure or hangs as named
+void failFirstAttempt(int, int attempt) {
+   if (attempt == 1) {
+      _Exit(1);
+   }
+}
+
+void failEveryAttempt(int, int) {
+   _Exit(1);
+}
+
+void hangFirstRange(int shard, int attempt) {
+   if (shard == 0 && attempt == 1) {
+      this_thread::sleep_for(chrono::hours(1));
+   }
+}
+
+//-------------------------- connectClient ----------------------------------
+// Connects to the query service's Unix socket, waiting for it to appear
+// Preconditions:   A service is starting or serving at path
+// Postconditions:  Returns a socket whose sends and reads give up after five
+//                  seconds, or -1 if nothing accepted within a second
+int connectClient(const char* path) {
+   sockaddr_un address;
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   strcpy(address.sun_path, path);
+
+   for (int attempt = 0; attempt < 100; attempt++) {
+      int client = socket(AF_UNIX, SOCK_STREAM, 0);
+      if (client >= 0
+         && connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+         timeval limit = { 5, 0 };
+         setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &limit, sizeof(limit));
+         setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &limit, sizeof(limit));
+         return client;
+      }
+      if (client >= 0) {
+         close(client);
+      }
+      this_thread::sleep_for(chrono::milliseconds(10));
+   }
+   return -1;
+}
+
+//-------------------------- sendText ---------------------------------------
+// Sends query lines to the service
+// Preconditions:   client is connected
+// Postconditions:  Returns true if every byte of text was sent
+bool sendText(int client, const string& text) {
+   size_t sent = 0;
+   while (sent < text.size()) {
+      ssize_t bytes = send(client, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+      if (bytes <= 0) {
+         return false;
+      }
+      sent += static_cast<size_t>(bytes);
+   }
+   return true;
+}
+
+//-------------------------- readAnswer -------------------------------------
+// Reads one answer line from the service
+// Preconditions:   client is connected and buffer holds bytes read earlier
+// Postconditions:  Returns the line without its newline and without the
+//                  latency and batch fields, which vary between runs; returns
+//                  "" if the socket closed or timed out first
+string readAnswer(int client, string& buffer) {
+   size_t newline = buffer.find('\n');
+   while (newline == string::npos) {
+      char chunk[4096];
+      ssize_t bytes = recv(client, chunk, sizeof(chunk), 0);
+      if (bytes <= 0) {
+         return "";
+      }
+      buffer.append(chunk, static_cast<size_t>(bytes));
+      newline = buffer.find('\n');
+   }
+
+   string line = buffer.substr(0, newline);
+   buffer.erase(0, newline + 1);
+   return line.substr(0, line.find(" latency_us="));
+}
+
+//-------------------------- writeGraph -------------------------------------
+// Writes a generated graph in the HW3.txt format with shuffled vertex ids,
+// as ids in real data files follow no useful order
+// Preconditions:   edges holds (src, dst, weight) triples over 1..size
+// Postconditions:  path holds the graph, each vertex renamed at random
+void writeGraph(const char* path, int size, const vector<vector<int>>& edges,
+   mt19937& random) {
+   vector<int> id(size + 1);
+   for (int v = 0; v <= size; v++) {
+      id[v] = v;
+   }
+   shuffle(id.begin() + 1, id.end(), random);
+
+   ofstream out(path);
+   out << size << endl;
+   for (int v = 1; v <= size; v++) {
+      out << "Vertex " << v << endl;
+   }
+   for (size_t e = 0; e < edges.size(); e++) {
+      out << id[edges[e][0]] << " " << id[edges[e][1]] << " " << edges[e][2] << endl;
+   }
+   out << "0 0 0" << endl;
+}
+
+//-------------------------- benchmark --------------------------------------
+// Times findShortestPath in every vertex order on a road-like grid and on a
+// power-law graph, each with 100 vertices and two-way edges
+// Preconditions:   runs >= 1 and the working directory is writable
+// Postconditions:  Prints the median time of one all-pairs run for each
+//                  graph, order and queue, and whether every order gave the
+//                  same distances as the input order
+int benchmark(int runs) {
+   const char* file = "HW3.bench";
+   const int SIDE = 10, VERTICES = SIDE * SIDE, LINKS = 2;
+   mt19937 random(502);
+   uniform_int_distribution<int> weight(1, 20);
+
+   for (int kind = 0; kind < 2; kind++) {
+      vector<vector<int>> edges;
+      if (kind == 0) {   // streets between neighbouring grid crossings
+         for (int v = 1; v <= VERTICES; v++) {
+            int right = v % SIDE == 0 ? 0 : v + 1;
+            int down = v + SIDE <= VERTICES ? v + SIDE : 0;
+            for (int u : { right, down }) {
+               if (u != 0) {
+                  int w = weight(random);
+                  edges.push_back({ v, u, w });
+                  edges.push_back({ u, v, w });
+               }
+            }
+         }
+      }
+      else {   // preferential attachment: new vertices link to popular ones
+         vector<int> ends = { 1, 2 };
+         edges.push_back({ 1, 2, weight(random) });
+         edges.push_back({ 2, 1, edges.back()[2] });
+         for (int v = 3; v <= VERTICES; v++) {
+            vector<int> chosen;
+            while (static_cast<int>(chosen.size()) < min(LINKS, v - 1)) {
+               int u = ends[random() % ends.size()];
+               if (find(chosen.begin(), chosen.end(), u) == chosen.end()) {
+                  chosen.push_back(u);
+               }
+            }
+            for (int u : chosen) {
+               int w = weight(random);
+               edges.push_back({ v, u, w });
+               edges.push_back({ u, v, w });
+               ends.push_back(u);
+               ends.push_back(v);
+            }
+         }
+      }
+      writeGraph(file, VERTICES, edges, random);
+
+      cout << (kind == 0 ? "road-like grid" : "power-law") << ", " << VERTICES
+         << " vertices, " << edges.size() << " edges (median us per findShortestPath)" << endl;
+      cout << setw(24) << left << "Order" << setw(10) << left << "auto"
+         << setw(10) << left << "scan" << "Distances" << endl;
+
+      const char* names[] = { "input", "bfs", "reverse cuthill-mckee", "degree" };
+      Graph::VertexOrder orders[] = { Graph::INPUT, Graph::BFS,
+         Graph::REVERSE_CUTHILL_MCKEE, Graph::DEGREE };
+      ifstream inputFile(file);
+      Graph input;
+      input.buildGraph(inputFile);
+
+      for (int o = 0; o < 4; o++) {
+         ifstream infile(file);
+         Graph G;
+         G.buildGraph(infile);
+         G.reorderVertices(orders[o]);
+         cout << setw(24) << left << names[o];
+
+         Graph::QueueStrategy strategies[] = { Graph::AUTO, Graph::SCAN };
+         for (int s = 0; s < 2; s++) {
+            G.setQueueStrategy(strategies[s]);
+            G.findShortestPath();   // warm up
+            vector<double> times;
+            for (int r = 0; r < runs; r++) {
+               chrono::steady_clock::time_point start = chrono::steady_clock::now();
+               G.findShortestPath();
+               times.push_back(chrono::duration<double, micro>(
+                  chrono::steady_clock::now() - start).count());
+            }
+            nth_element(times.begin(), times.begin() + runs / 2, times.end());
+            cout << setw(10) << left << fixed << setprecision(1) << times[runs / 2];
+         }
+
+         bool same = true;
+         for (int src = 1; src <= VERTICES && same; src++) {
+            vector<int> expected, reordered, path;
+            input.findShortestPathFrom(src, expected, path);
+            G.findShortestPathFrom(src, reordered, path);
+            same = expected == reordered;
+         }
+         cout << (same ? "same" : "DIFFERENT") << endl;
+      }
+      cout << endl;
+   }
+
+   remove(file);
+   return 0;
+}
+
 //-------------------------- main -------------------------------------------
 // Tests the Graph class by reading data from "HW3.txt" 
 // Preconditions:   If lab3.txt file exists, it must be formatted
@@ -22,7 +258,29 @@ using namespace std;
 // Postconditions:  The basic functionalities of the Graph class 
 //                  are used.  Should compile, run to completion, and output  
 //                  correct answers if the classes are implemented correctly.
-int main() {
+//                  With --serve, queries are answered until EOF or shutdown;
+//                  with --bench, only the benchmark runs.
+int main(int argc, char* argv[]) {
+   if (argc >= 3 && string(argv[1]) == "--serve") {
+      ifstream graphFile(argv[2]);
+      if (!graphFile) {
+         cerr << "File could not be opened." << endl;
+         return 1;
+      }
+
+      Graph resident;
+      resident.buildGraph(graphFile);
+      QueryService service(resident);
+      if (argc >= 4) {
+         return service.serveSocket(argv[3]);
+      }
+      return service.serveStream(0, 1);
+   }
+   if (argc >= 2 && string(argv[1]) == "--bench") {
+      int runs = argc >= 3 ? atoi(argv[2]) : 200;
+      return benchmark(runs < 1 ? 1 : runs);
+   }
+
    ifstream infile1("HW3.txt");
    if (!infile1) {
       cerr << "File could not be opened." << endl;
@@ -74,6 +332,284 @@ int main() {
    G2.printEdges();
    G2.printVertices();
 
+   cout << endl << "-----Testing Concurrent Queries During Edge Updates----" << endl;
+   const int READERS = 4, QUERIES = 200, WRITERS = 2, UPDATES = 500;
+   Graph G3(G);
+   vector<thread> threads;
+   atomic<bool> monotonic(true);
+   atomic<bool> consistent(true);
+   atomic<int> writing(WRITERS);
+   for (int r = 0; r < READERS; r++) {
+      // keep querying until the writers finish so that the two overlap even
+      // when the threads share one core
+      threads.push_back(thread([&G3, &monotonic, &consistent, &writing]() {
+         unsigned long seen = 0;
+         vector<int> dist, path;
+         for (int q = 0; q < QUERIES || writing > 0; q++) {
+            G3.findShortestPath();
+            unsigned long now = G3.getVersion();
+            if (now < seen) {
+               monotonic = false;
+            }
+            seen = now;
+
+            // each run reads every edge list once, so it sees 1 -> 2 either
+            // present (1 2 4 costs 20) or removed (2 is unreachable and
+            // 1 3 4 costs 5 plus 20 or 25)
+            G3.findShortestPathFrom(1, dist, path);
+            bool withEdge = dist[2] == 10 && dist[4] == 20 && path[4] == 2;
+            bool withoutEdge = dist[2] == WeightTraits<int>::infinity()
+               && (dist[4] == 25 || dist[4] == 30) && path[4] == 3;
+            if (dist[3] != 5 || (!withEdge && !withoutEdge)) {
+               consistent = false;
+            }
+         }
+      }));
+   }
+   threads.push_back(thread([&G3, &writing]() {   // drop and restore an edge
+      for (int u = 0; u < UPDATES; u++) {
+         G3.removeEdge(1, 2);
+         this_thread::yield();
+         G3.insertEdge(1, 2, 10);
+         this_thread::yield();
+      }
+      writing--;
+   }));
+   threads.push_back(thread([&G3, &writing]() {   // reweight an edge
+      for (int u = 0; u < UPDATES; u++) {
+         G3.insertEdge(3, 4, 25);
+         this_thread::yield();
+         G3.insertEdge(3, 4, 20);
+         this_thread::yield();
+      }
+      writing--;
+   }));
+   for (size_t t = 0; t < threads.size(); t++) {
+      threads[t].join();
+   }
+   cout << READERS << " readers ran at least " << READERS * QUERIES << " queries while "
+      << WRITERS << " writers published " << G3.getVersion() << " updates" << endl;
+   cout << "Versions seen in order: " << (monotonic ? "yes" : "no") << endl;
+   cout << "Distances from 1 matched a published version: "
+      << (consistent ? "yes" : "no") << endl;
+   if (!monotonic || !consistent) {
+      return 1;
+   }
+   G3.findShortestPath();
+   G3.displayAll();
+
+   cout << endl << "-----Testing Queue Strategies----" << endl;
+   const char* names[] = { "auto", "scan", "binary heap", "dial", "radix" };
+   Graph::QueueStrategy strategies[] = { Graph::AUTO, Graph::SCAN,
+      Graph::BINARY_HEAP, Graph::DIAL, Graph::RADIX };
+   for (int s = 0; s < 5; s++) {
+      G.setQueueStrategy(strategies[s]);
+      cout << names[s] << " (uses " << names[G.getQueueStrategy()] << "):" << endl;
+      G.findShortestPath();
+      G.display(1, 4);
+      G.display(2, 3);
+   }
+   G.insertEdge(4, 1, 1000);  // heavier than Dial's limit
+   G.setQueueStrategy(Graph::AUTO);
+   cout << "auto after a weight of 1000 (uses " << names[G.getQueueStrategy()] << "):" << endl;
+   G.findShortestPath();
+   G.display(4, 3);
+
+   cout << endl << "-----Testing Vertex Id and Weight Types----" << endl;
+   ifstream infile2("HW3.txt");
+   BasicGraph<uint32_t, int64_t> G4;
+   G4.buildGraph(infile2);
+   G4.insertEdge(4, 1, 3000000000LL);  // too large for a 32-bit distance
+   G4.findShortestPath();
+   G4.display(4, 3);
+
+   ifstream infile3("HW3.txt");
+   BasicGraph<uint16_t, uint16_t> G5;
+   G5.buildGraph(infile3);
+   G5.insertEdge(4, 1, 65530);  // 4 1 3 saturates at 65535
+   G5.findShortestPath();
+   G5.display(4, 1);
+   G5.display(4, 3);
+
+   ifstream infile4("HW3.txt");
+   BasicGraph<uint16_t, double> G6;
+   G6.buildGraph(infile4);
+   G6.insertEdge(4, 1, 0.5);
+   G6.findShortestPath();
+   G6.display(4, 3);
+
+   cout << endl << "-----Testing Sharded All-Pairs----" << endl;
+   ifstream infile5("HW3.txt");
+   Graph G7;
+   G7.buildGraph(infile5);
+   if (!G7.findShortestPathSharded("HW3.rows", 3)) {
+      cerr << "Sharded run failed." << endl;
+      return 1;
+   }
+   G7.displayAll();
+   cout << "Every attempt failing: "
+      << (G7.findShortestPathSharded("HW3.rows", 3, 10000, failEveryAttempt) ? "complete" : "failed")
+      << endl;
+   cout << "Hung first range killed after 200 ms: "
+      << (G7.findShortestPathSharded("HW3.rows", 3, 200, hangFirstRange) ? "complete" : "failed")
+      << endl;
+   cout << "First attempt of every range failing: "   // leaves a complete file
+      << (G7.findShortestPathSharded("HW3.rows", 3, 10000, failFirstAttempt) ? "complete" : "failed")
+      << endl;
+   ifstream infile6("HW3.txt");
+   Graph G8;
+   G8.buildGraph(infile6);
+   if (!G8.attachResults("HW3.rows")) {   // display without computing
+      cerr << "Result file could not be attached." << endl;
+      return 1;
+   }
+   G8.display(2, 3);
+   ifstream infile8("HW3.txt");
+   BasicGraph<uint32_t, int32_t> G10;   // same entry size, other vertex id type
+   G10.buildGraph(infile8);
+   cout << "Attached by a graph with uint32_t ids: "
+      << (G10.attachResults("HW3.rows") ? "yes" : "no") << endl;
+
+   cout << endl << "-----Testing K Shortest Paths----" << endl;
+   G8.insertEdge(4, 3, 5);
+   G8.insertEdge(2, 3, 40);
+   vector<Graph::Path> paths = G8.kShortestPaths(1, 3, 5);
+   for (size_t p = 0; p < paths.size(); p++) {
+      cout << setw(6) << left << paths[p].cost;
+      for (size_t v = 0; v < paths[p].vertices.size(); v++) {
+         cout << (v == 0 ? "" : " ") << paths[p].vertices[v];
+      }
+      cout << endl;
+   }
+
+   cout << endl << "-----Testing Reachability----" << endl;
+   G8.removeEdge(4, 3);   // The Commons is a sink again
+   cout << "1 -> 4: " << (G8.isReachable(1, 4) ? "reachable" : "unreachable") << endl;
+   cout << "4 -> 1: " << (G8.isReachable(4, 1) ? "reachable" : "unreachable") << endl;
+   G8.insertEdge(4, 1, 7);   // joins every vertex into one component
+   cout << "4 -> 3 after inserting 4 1: "
+      << (G8.isReachable(4, 3) ? "reachable" : "unreachable") << endl;
+   G8.removeEdge(4, 1);
+   cout << "4 -> 3 after removing 4 1: "
+      << (G8.isReachable(4, 3) ? "reachable" : "unreachable") << endl;
+
+   cout << endl << "-----Testing Vertex Reordering----" << endl;
+   ifstream infile7("HW3.txt");
+   Graph G9;
+   G9.buildGraph(infile7);
+   G9.findShortestPath();
+   G9.reorderVertices(Graph::REVERSE_CUTHILL_MCKEE);   // ids printed stay the same
+   G9.printVertices();
+   G9.printEdges();
+   G9.displayAll();   // rows computed before reordering
+   Graph G12(G9);   // copies keep the reordered layout
+   G12.printEdges();
+   G12.findShortestPath();
+   G12.display(2, 3);
+   if (!G12.findShortestPathSharded("HW3.reordered.rows", 2)) {
+      cerr << "Sharded run failed." << endl;
+      return 1;
+   }
+   ifstream infile10("HW3.txt");
+   Graph G13;
+   G13.buildGraph(infile10);
+   G13.attachResults("HW3.reordered.rows");   // written in another layout
+   G13.display(2, 3);
+   G13.reorderVertices(Graph::DEGREE);   // detaches the file
+   G13.attachResults("HW3.reordered.rows");
+   G13.display(2, 3);
+   G9.removeEdge(2, 1);
+   G9.findShortestPath();
+   G9.display(2, 3);
+
+   cout << endl << "-----Testing Query Service----" << endl;
+   const char* socketPath = "HW3.sock";
+   ifstream infile9("HW3.txt");
+   Graph G11;
+   G11.buildGraph(infile9);
+   thread server([&G11, socketPath]() {
+      QueryService service(G11);
+      service.serveSocket(socketPath);
+   });
+
+   // an earlier client is answered and half-closes while a later one is
+   // still open, so closing the first shifts the second down
+   int first = connectClient(socketPath);
+   int later = connectClient(socketPath);
+   string firstBuffer, laterBuffer;
+   bool firstAnswered = first >= 0 && sendText(first, "path 2 3\n")
+      && readAnswer(first, firstBuffer) == "path 2 3 dist=20 path=2,1,3";
+   // a last query without its newline is still answered at EOF
+   firstAnswered = firstAnswered && sendText(first, "from 3");
+   if (first >= 0) {
+      shutdown(first, SHUT_WR);
+   }
+   firstAnswered = firstAnswered && readAnswer(first, firstBuffer) == "from 3 dist=5,15,0,20";
+   cout << "Unterminated last query answered: " << (firstAnswered ? "yes" : "no") << endl;
+   this_thread::sleep_for(chrono::milliseconds(20));   // let the service see the EOF
+   string laterAnswer;
+   if (later >= 0 && sendText(later, "path 1 4\n")) {
+      laterAnswer = readAnswer(later, laterBuffer);
+   }
+   cout << laterAnswer << endl;
+   bool laterAnswered = firstAnswered && laterAnswer == "path 1 4 dist=20 path=1,2,4";
+   cout << "Later client answered after an earlier one closed: "
+      << (laterAnswered ? "yes" : "no") << endl;
+   if (first >= 0) {
+      close(first);
+   }
+
+   // one client floods queries and reads nothing until the other is done
+   const int SLOW_QUERIES = 20000;
+   int slow = connectClient(socketPath);
+   string flood;
+   for (int q = 0; q < SLOW_QUERIES; q++) {
+      flood += "from 1\n";
+   }
+   bool slowSent = slow >= 0 && sendText(slow, flood);
+
+   int quick = connectClient(socketPath);
+   string quickBuffer;
+   const char* expected[] = { "path 2 3 dist=20 path=2,1,3", "path 4 1 dist=--",
+      "from 2 dist=15,0,20,10", "error unknown query \"bogus\"" };
+   bool answered = quick >= 0 && sendText(quick, "path 2 3\npath 4 1\nfrom 2\nbogus\n");
+   for (int a = 0; a < 4 && answered; a++) {
+      string answer = readAnswer(quick, quickBuffer);
+      cout << answer << endl;
+      answered = answer == expected[a];
+   }
+   cout << "Answers while another client is not reading: "
+      << (answered ? "correct" : "wrong") << endl;
+
+   string slowBuffer;
+   int slowAnswers = 0;
+   while (slowSent && slowAnswers < SLOW_QUERIES
+      && readAnswer(slow, slowBuffer) == "from 1 dist=0,10,5,20") {
+      slowAnswers++;
+   }
+   cout << "Answers read late by the flooding client: " << slowAnswers << " of "
+      << SLOW_QUERIES << endl;
+
+   bool stopped = quick >= 0 && sendText(quick, "shutdown\n")
+      && readAnswer(quick, quickBuffer) == "shutdown";
+   cout << "Service stopped: " << (stopped ? "yes" : "no") << endl;
+   if (slow >= 0) {
+      close(slow);
+   }
+   if (quick >= 0) {
+      close(quick);
+   }
+   if (later >= 0) {
+      close(later);
+   }
+   if (!stopped) {
+      server.detach();
+      return 1;
+   }
+   server.join();
+   if (!laterAnswered || !answered || slowAnswers != SLOW_QUERIES) {
+      return 1;
+   }
 
 
    //for each graph, find the shortest path from every node to all other nodes
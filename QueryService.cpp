@@ -0,0 +1,511 @@
+//--------------------------------------------------------------------
+// QUERYSERVICE.CPP
+// Implementation of the QueryService class
+// Author: [Your Name]
+//--------------------------------------------------------------------
+// QueryService class:
+//   Answers shortest path queries against a graph that stays loaded,
+//   batching queries that share a source into one Dijkstra run.
+//   Socket clients are non-blocking, with answers buffered per client.
+//   Assumptions:
+//      - The graph is built before the service starts and outlives it
+//      - Lines are at most MAX_LINE characters
+//--------------------------------------------------------------------
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "QueryService.h"
+
+using namespace std;
+
+//-------------------------------- QueryService -------------------------------
+// QueryService constructor
+// Preconditions:  graph has been built
+// Postconditions: The service answers queries against graph
+QueryService::QueryService(const Graph& graph)
+   : graph(graph), listener(-1), nextId(1), stopping(false) {
+}
+
+//-------------------------------- ~QueryService ------------------------------
+// Destructor for the QueryService class
+// Preconditions:  None
+// Postconditions: All client connections and the listening socket are closed
+QueryService::~QueryService() {
+   closeAll();
+}
+
+//-------------------------------- serveStream --------------------------------
+// Answers queries read from in, writing answers to out
+// Preconditions:  in is readable and out is writable (e.g. stdin and stdout)
+// Postconditions: Returns 0 once in reaches EOF or a shutdown query arrives,
+//                 after every query read has been answered
+int QueryService::serveStream(int in, int out) {
+   Connection stream;
+   stream.id = nextId++;
+   stream.in = in;
+   stream.out = out;
+   stream.isSocket = false;
+   stream.reading = true;
+   stream.failed = false;
+   connections.push_back(stream);
+
+   serve();
+   closeAll();
+   return 0;
+}
+
+//-------------------------------- serveSocket --------------------------------
+// Answers queries from clients of a Unix socket at path
+// Preconditions:  path names a location the process may create a socket at
+// Postconditions: Returns 0 after a shutdown query, or 1 if the socket cannot
+//                 be created. Any existing file at path is replaced, and the
+//                 socket file is removed on return.
+int QueryService::serveSocket(const char* path) {
+   sockaddr_un address;
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   if (strlen(path) >= sizeof(address.sun_path)) {
+      return 1;
+   }
+   strcpy(address.sun_path, path);
+
+   listener = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (listener < 0) {
+      return 1;
+   }
+
+   unlink(path);
+   if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+      || listen(listener, SOMAXCONN) != 0) {
+      closeAll();
+      return 1;
+   }
+
+   serve();
+   closeAll();
+   unlink(path);
+   return 0;
+}
+
+//--------------------------------- serve ----------------------------------
+// Polls the listener and connections, batching and answering queries
+// Preconditions:  connections holds at least one connection or listener >= 0
+// Postconditions: Returns once stopping is set or no input is left
+void QueryService::serve() {
+   while (!stopping) {
+      // close before indexing connections: erasing shifts every later index
+      if (pending.empty()) {
+         closeFinished();
+      }
+
+      vector<pollfd> fds;
+      vector<size_t> polledConnection; // connection index of each fd
+      for (size_t c = 0; c < connections.size(); c++) {
+         short events = 0;
+         if (connections[c].reading) {
+            events |= POLLIN;
+         }
+         if (!connections[c].output.empty()) {
+            events |= POLLOUT;
+         }
+         if (events != 0) {
+            pollfd fd = { connections[c].in, events, 0 };
+            fds.push_back(fd);
+            polledConnection.push_back(c);
+         }
+      }
+      if (listener >= 0) {
+         pollfd fd = { listener, POLLIN, 0 };
+         fds.push_back(fd);
+      }
+      if (fds.empty()) { // the stream ended
+         break;
+      }
+
+      // keep collecting until the oldest pending query has waited a full window
+      int timeout = -1;
+      if (!pending.empty()) {
+         long waited = static_cast<long>(chrono::duration_cast<chrono::microseconds>(
+            Clock::now() - pending.front().received).count());
+         if (waited >= BATCH_WINDOW_US || pending.size() >= MAX_BATCH) {
+            answerBatch();
+            continue;
+         }
+         timeout = static_cast<int>((BATCH_WINDOW_US - waited + 999) / 1000);
+      }
+
+      int ready = poll(fds.data(), fds.size(), timeout);
+      if (ready < 0) {
+         if (errno == EINTR) {
+            continue;
+         }
+         break;
+      }
+      if (ready == 0) {
+         answerBatch();
+         continue;
+      }
+
+      // a client that stopped sending keeps its connection until answered
+      size_t polled = polledConnection.size();
+      for (size_t f = 0; f < polled; f++) {
+         size_t c = polledConnection[f];
+         if (fds[f].revents == 0) {
+            continue;
+         }
+         if (fds[f].events & POLLOUT) {
+            flush(c);
+         }
+         if ((fds[f].events & POLLIN) && (fds[f].revents & ~POLLOUT)
+            && connections[c].reading && !readFrom(c)) {
+            connections[c].reading = false;
+         }
+      }
+
+      if (listener >= 0 && (fds[polled].revents & POLLIN)) {
+         int client = accept(listener, nullptr, nullptr);
+         if (client >= 0) {
+            // a client that stops reading must not stall the others
+            fcntl(client, F_SETFL, fcntl(client, F_GETFL) | O_NONBLOCK);
+
+            Connection connection;
+            connection.id = nextId++;
+            connection.in = client;
+            connection.out = client;
+            connection.isSocket = true;
+            connection.reading = true;
+            connection.failed = false;
+            connections.push_back(connection);
+         }
+      }
+   }
+
+   answerBatch();
+   drain();
+}
+
+//-------------------------------- readFrom --------------------------------
+// Reads available bytes from a connection and queues complete lines
+// Preconditions:  c indexes connections and its descriptor is readable
+// Postconditions: Returns false if the connection reached EOF or failed; at
+//                 EOF an unterminated last line is queued as a query too
+bool QueryService::readFrom(size_t c) {
+   char chunk[4096];
+   ssize_t bytes = read(connections[c].in, chunk, sizeof(chunk));
+   if (bytes < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return true;
+   }
+   string& buffer = connections[c].buffer;
+   if (bytes == 0 && !buffer.empty()) { // a last line without its newline
+      Query query;
+      query.connection = connections[c].id;
+      query.line = buffer;
+      query.received = Clock::now();
+      if (query.line[query.line.size() - 1] == '\r') {
+         query.line.erase(query.line.size() - 1);
+      }
+      if (!query.line.empty()) {
+         pending.push_back(query);
+      }
+      buffer.clear();
+   }
+   if (bytes <= 0) {
+      return false;
+   }
+
+   Clock::time_point now = Clock::now();
+   buffer.append(chunk, static_cast<size_t>(bytes));
+
+   size_t start = 0;
+   size_t newline = buffer.find('\n');
+   while (newline != string::npos) {
+      Query query;
+      query.connection = connections[c].id;
+      query.line = buffer.substr(start, newline - start);
+      query.received = now;
+      if (!query.line.empty() && query.line[query.line.size() - 1] == '\r') {
+         query.line.erase(query.line.size() - 1);
+      }
+      if (!query.line.empty()) {
+         pending.push_back(query);
+      }
+      start = newline + 1;
+      newline = buffer.find('\n', start);
+   }
+   buffer.erase(0, start);
+
+   if (buffer.size() > MAX_LINE) {
+      Query query;
+      query.connection = connections[c].id;
+      query.received = now;
+      reply(query, "error line too long");
+      buffer.clear();
+   }
+   return true;
+}
+
+//------------------------------ answerBatch -------------------------------
+// Answers every pending query, one Dijkstra run per distinct source
+// Preconditions:  None
+// Postconditions: pending is empty, every query has been answered and
+//                 connections that stopped sending are closed
+void QueryService::answerBatch() {
+   // parse every query first so that shared sources are known
+   vector<string> command(pending.size());
+   vector<int> src(pending.size(), 0);
+   vector<int> dst(pending.size(), 0);
+   map<int, size_t> sourceIndex; // source vertex -> run
+   for (size_t q = 0; q < pending.size(); q++) {
+      istringstream words(pending[q].line);
+      string extra;
+      words >> command[q];
+      if (command[q] == "path") {
+         words >> src[q] >> dst[q];
+      }
+      else if (command[q] == "from") {
+         words >> src[q];
+      }
+      if (words.fail() || (words >> extra)) {
+         command[q] = "";
+      }
+
+      // the reachability index answers unreachable pairs without a run
+      if (command[q] == "path" && dst[q] >= 1 && dst[q] <= graph.getSize()
+         && src[q] >= 1 && src[q] <= graph.getSize() && !graph.isReachable(src[q], dst[q])) {
+         command[q] = "unreachable";
+      }
+
+      if ((command[q] == "path" || command[q] == "from") && sourceIndex.count(src[q]) == 0) {
+         size_t run = sourceIndex.size();
+         sourceIndex[src[q]] = run;
+      }
+   }
+
+   vector<vector<int>> dist(sourceIndex.size());
+   vector<vector<int>> path(sourceIndex.size());
+   vector<bool> valid(sourceIndex.size(), false);
+   for (map<int, size_t>::iterator run = sourceIndex.begin(); run != sourceIndex.end(); run++) {
+      valid[run->second] = graph.findShortestPathFrom(run->first, dist[run->second],
+         path[run->second]);
+   }
+
+   string shared = " batch=" + to_string(pending.size()) + " sources="
+      + to_string(sourceIndex.size());
+   const int unreachable = WeightTraits<int>::infinity();
+
+   for (size_t q = 0; q < pending.size(); q++) {
+      ostringstream answer;
+
+      if (command[q] == "shutdown") {
+         stopping = true;
+         answer << "shutdown";
+      }
+      else if (command[q] == "unreachable") {
+         answer << "path " << src[q] << " " << dst[q] << " dist=--";
+      }
+      else if (command[q] == "path" || command[q] == "from") {
+         size_t run = sourceIndex[src[q]];
+         int vertices = static_cast<int>(dist[run].size()) - 1;
+
+         if (!valid[run]) {
+            answer << "error no vertex " << src[q];
+         }
+         else if (command[q] == "path" && (dst[q] < 1 || dst[q] > vertices)) {
+            answer << "error no vertex " << dst[q];
+         }
+         else if (command[q] == "path") {
+            answer << "path " << src[q] << " " << dst[q];
+            if (dist[run][dst[q]] == unreachable) {
+               answer << " dist=--";
+            }
+            else {
+               // walk back from dst, then print forwards
+               vector<int> reversed;
+               for (int v = dst[q]; v != 0; v = path[run][v]) {
+                  reversed.push_back(v);
+               }
+               answer << " dist=" << dist[run][dst[q]] << " path=";
+               for (size_t v = reversed.size(); v-- > 0;) {
+                  answer << reversed[v] << (v == 0 ? "" : ",");
+               }
+            }
+         }
+         else {
+            answer << "from " << src[q] << " dist=";
+            for (int v = 1; v <= vertices; v++) {
+               if (dist[run][v] == unreachable) {
+                  answer << "--";
+               }
+               else {
+                  answer << dist[run][v];
+               }
+               answer << (v == vertices ? "" : ",");
+            }
+         }
+      }
+      else {
+         answer << "error unknown query \"" << pending[q].line << "\"";
+      }
+
+      long latency = static_cast<long>(chrono::duration_cast<chrono::microseconds>(
+         Clock::now() - pending[q].received).count());
+      if (answer.str().compare(0, 5, "error") != 0 && command[q] != "shutdown") {
+         answer << " latency_us=" << latency << shared;
+      }
+      reply(pending[q], answer.str());
+   }
+
+   pending.clear();
+   closeFinished();
+}
+
+//------------------------------ closeFinished -----------------------------
+// Closes connections whose client stopped sending and has every answer
+// Preconditions:  No pending query belongs to such a connection
+// Postconditions: Only connections still sending queries or still owed
+//                 answers remain
+void QueryService::closeFinished() {
+   for (size_t c = connections.size(); c-- > 0;) {
+      if (!connections[c].reading && connections[c].output.empty()) {
+         if (connections[c].isSocket) {
+            close(connections[c].in);
+         }
+         connections.erase(connections.begin() + c);
+      }
+   }
+}
+
+//---------------------------------- reply ----------------------------------
+// Sends one answer line to the connection a query came from
+// Preconditions:  None
+// Postconditions: text and a newline are written to a stream, or queued for
+//                 a socket client and written as far as it accepts without
+//                 blocking; dropped if the client has failed
+void QueryService::reply(const Query& query, const string& text) {
+   for (size_t c = 0; c < connections.size(); c++) {
+      Connection& connection = connections[c];
+      if (connection.id != query.connection) {
+         continue;
+      }
+      if (connection.failed) {
+         return;
+      }
+
+      string line = text + "\n";
+      if (connection.isSocket) {
+         connection.output += line;
+         if (connection.output.size() > MAX_OUTPUT) { // not reading; give up on it
+            connection.output.clear();
+            connection.failed = true;
+            connection.reading = false;
+            return;
+         }
+         flush(c);
+         return;
+      }
+
+      // a stream has no other client to hold up
+      size_t written = 0;
+      while (written < line.size()) {
+         ssize_t bytes = write(connection.out, line.data() + written, line.size() - written);
+         if (bytes < 0 && errno == EINTR) {
+            continue;
+         }
+         if (bytes <= 0) { // the client went away; drop the answer
+            connection.failed = true;
+            return;
+         }
+         written += static_cast<size_t>(bytes);
+      }
+      return;
+   }
+}
+
+//---------------------------------- flush ----------------------------------
+// Writes queued answers to a socket client without blocking
+// Preconditions:  c indexes connections
+// Postconditions: output holds what the client could not take yet; a
+//                 client whose socket failed is marked failed
+void QueryService::flush(size_t c) {
+   Connection& connection = connections[c];
+   size_t written = 0;
+   while (written < connection.output.size()) {
+      ssize_t bytes = send(connection.out, connection.output.data() + written,
+         connection.output.size() - written, MSG_NOSIGNAL);
+      if (bytes < 0 && errno == EINTR) {
+         continue;
+      }
+      if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+         break;
+      }
+      if (bytes <= 0) { // the client went away; drop its answers
+         connection.output.clear();
+         connection.failed = true;
+         connection.reading = false;
+         return;
+      }
+      written += static_cast<size_t>(bytes);
+   }
+   connection.output.erase(0, written);
+}
+
+//---------------------------------- drain ----------------------------------
+// Writes the remaining queued answers before the service stops
+// Preconditions:  None
+// Postconditions: Every output buffer is written, or a client took nothing
+//                 for DRAIN_TIMEOUT_MS
+void QueryService::drain() {
+   while (true) {
+      vector<pollfd> fds;
+      vector<size_t> polledConnection;
+      for (size_t c = 0; c < connections.size(); c++) {
+         if (!connections[c].output.empty()) {
+            pollfd fd = { connections[c].out, POLLOUT, 0 };
+            fds.push_back(fd);
+            polledConnection.push_back(c);
+         }
+      }
+      if (fds.empty()) {
+         return;
+      }
+
+      int ready = poll(fds.data(), fds.size(), DRAIN_TIMEOUT_MS);
+      if (ready < 0 && errno == EINTR) {
+         continue;
+      }
+      if (ready <= 0) {
+         return;
+      }
+      for (size_t f = 0; f < fds.size(); f++) {
+         if (fds[f].revents != 0) {
+            flush(polledConnection[f]);
+         }
+      }
+   }
+}
+
+//-------------------------------- closeAll --------------------------------
+// Closes every connection and the listener
+// Preconditions:  None
+// Postconditions: connections is empty and listener is -1
+void QueryService::closeAll() {
+   for (size_t c = 0; c < connections.size(); c++) {
+      if (connections[c].isSocket) {
+         close(connections[c].in);
+      }
+   }
+   connections.clear();
+
+   if (listener >= 0) {
+      close(listener);
+      listener = -1;
+   }
+}
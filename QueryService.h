@@ -0,0 +1,162 @@
+//--------------------------------------------------------------------
+// QUERYSERVICE.H
+// Declaration of the QueryService class
+// Author: [Your Name]
+//--------------------------------------------------------------------
+// QueryService class:
+//   Answers shortest path queries against a graph that stays loaded.
+//   Queries are read one per line from stdin or from clients of a local
+//   Unix socket; the last line needs no newline if the input ends there. Queries that arrive within BATCH_WINDOW_US of the first
+//   pending one form a batch, and every query in a batch that shares a
+//   source is answered from a single Dijkstra run. Each answer reports
+//   the latency of its query, from when the line was read to when the
+//   answer was written. A path query between vertices the graph's
+//   reachability index proves unconnected is answered without a run.
+//   Socket clients are non-blocking: answers wait in a per-client buffer
+//   until the client reads them, so a client that stops reading only
+//   delays itself. One that falls more than MAX_OUTPUT bytes behind is
+//   disconnected.
+//   Queries:
+//      path SRC DST   ->  path SRC DST dist=D path=SRC,...,DST latency_us=L batch=Q sources=S
+//                         (dist=-- and no path= if DST is unreachable)
+//      from SRC       ->  from SRC dist=D1,D2,...,Dn latency_us=L batch=Q sources=S
+//      shutdown       ->  stops the service after answering pending queries
+//   anything else     ->  error <reason>
+//   Using the following methods:
+//      QueryService - constructor that attaches the service to a graph
+//      ~QueryService - destructor that closes all connections
+//      serveStream - answers queries from a pair of file descriptors until EOF
+//      serveSocket - answers queries from Unix socket clients until shutdown
+//   Assumptions:
+//      - The graph is built before the service starts and outlives it
+//      - Lines are at most MAX_LINE characters
+//--------------------------------------------------------------------
+
+#pragma once
+#include <chrono>
+#include <string>
+#include <vector>
+#include "Graph.h"
+
+using namespace std;
+
+class QueryService {
+public:
+   //-------------------------------- QueryService -------------------------------
+   // QueryService constructor
+   // Preconditions:  graph has been built
+   // Postconditions: The service answers queries against graph
+   QueryService(const Graph& graph);
+
+   //-------------------------------- ~QueryService ------------------------------
+   // Destructor for the QueryService class
+   // Preconditions:  None
+   // Postconditions: All client connections and the listening socket are closed
+   ~QueryService();
+
+   QueryService(const QueryService&) = delete;
+   QueryService& operator=(const QueryService&) = delete;
+
+   //-------------------------------- serveStream --------------------------------
+   // Answers queries read from in, writing answers to out
+   // Preconditions:  in is readable and out is writable (e.g. stdin and stdout)
+   // Postconditions: Returns 0 once in reaches EOF or a shutdown query arrives,
+   //                 after every query read has been answered
+   int serveStream(int in, int out);
+
+   //-------------------------------- serveSocket --------------------------------
+   // Answers queries from clients of a Unix socket at path
+   // Preconditions:  path names a location the process may create a socket at
+   // Postconditions: Returns 0 after a shutdown query, or 1 if the socket cannot
+   //                 be created. Any existing file at path is replaced, and the
+   //                 socket file is removed on return.
+   int serveSocket(const char* path);
+
+private:
+   typedef chrono::steady_clock Clock;
+
+   static const int BATCH_WINDOW_US = 1000; // wait for more queries after the first
+   static const size_t MAX_BATCH = 256; // answer at once when this many are pending
+   static const size_t MAX_LINE = 256; // longer lines are rejected
+   static const size_t MAX_OUTPUT = 4 << 20; // unread answer bytes before a client is dropped
+   static const int DRAIN_TIMEOUT_MS = 1000; // wait for slow readers after shutdown
+
+   struct Connection {
+      int id; // identifies the connection in queries
+      int in; // descriptor queries are read from
+      int out; // descriptor answers are written to
+      string buffer; // bytes read but not yet ending in a newline
+      string output; // answers not yet written to a socket client
+      bool isSocket; // accepted client, closed by the service
+      bool reading; // false once the client stopped sending; answers still go out
+      bool failed; // the client went away or fell behind; answers are dropped
+   };
+
+   struct Query {
+      int connection; // Connection::id of the client
+      string line; // query text without the newline
+      Clock::time_point received; // when the line was read
+   };
+
+   const Graph& graph;
+   vector<Connection> connections;
+   vector<Query> pending; // read but not yet answered
+   int listener; // listening socket, -1 if serving a stream
+   int nextId; // id of the next connection
+   bool stopping; // a shutdown query was read
+
+   //--------------------------------- serve ----------------------------------
+   // Polls the listener and connections, batching and answering queries
+   // Preconditions:  connections holds at least one connection or listener >= 0
+   // Postconditions: Returns once stopping is set or no input is left
+   void serve();
+
+   //-------------------------------- readFrom --------------------------------
+   // Reads available bytes from a connection and queues complete lines
+   // Preconditions:  c indexes connections and its descriptor is readable
+   // Postconditions: Returns false if the connection reached EOF or failed; at
+   //                 EOF an unterminated last line is queued as a query too
+   bool readFrom(size_t c);
+
+   //------------------------------ answerBatch -------------------------------
+   // Answers every pending query, one Dijkstra run per distinct source
+   // Preconditions:  None
+   // Postconditions: pending is empty, every query has been answered and
+   //                 connections that stopped sending are closed
+   void answerBatch();
+
+   //------------------------------ closeFinished -----------------------------
+   // Closes connections whose client stopped sending and has every answer
+   // Preconditions:  No pending query belongs to such a connection
+   // Postconditions: Only connections still sending queries or still owed
+   //                 answers remain
+   void closeFinished();
+
+   //---------------------------------- reply ----------------------------------
+   // Sends one answer line to the connection a query came from
+   // Preconditions:  None
+   // Postconditions: text and a newline are written to a stream, or queued for
+   //                 a socket client and written as far as it accepts without
+   //                 blocking; dropped if the client has failed
+   void reply(const Query& query, const string& text);
+
+   //---------------------------------- flush ----------------------------------
+   // Writes queued answers to a socket client without blocking
+   // Preconditions:  c indexes connections
+   // Postconditions: output holds what the client could not take yet; a
+   //                 client whose socket failed is marked failed
+   void flush(size_t c);
+
+   //---------------------------------- drain ----------------------------------
+   // Writes the remaining queued answers before the service stops
+   // Preconditions:  None
+   // Postconditions: Every output buffer is written, or a client took nothing
+   //                 for DRAIN_TIMEOUT_MS
+   void drain();
+
+   //-------------------------------- closeAll --------------------------------
+   // Closes every connection and the listener
+   // Preconditions:  None
+   // Postconditions: connections is empty and listener is -1
+   void closeAll();
+};
@@ -0,0 +1,212 @@
+//--------------------------------------------------------------------
+// QUEUES.CPP
+// Implementation of the priority queues used by Dijkstra's algorithm
+// Author: [Your Name]
+//--------------------------------------------------------------------
+// HeapQueue, BucketQueue and RadixHeap classes:
+//   Min-priority queues of (key, vertex) pairs that share one interface
+//   so that findShortestPath can run with any of them.
+//   Explicit instantiations for the supported key types are at the end.
+//   Assumptions:
+//      - Keys are non-negative
+//      - BucketQueue and RadixHeap are monotone
+//--------------------------------------------------------------------
+
+#include <cstdint>
+
+#include "Queues.h"
+
+using namespace std;
+
+//--------------------------------- push ----------------------------------
+// Adds a vertex with the given key
+// Preconditions:  key is non-negative
+// Postconditions: The (key, v) entry is in the queue
+template <typename Key>
+void HeapQueue<Key>::push(Key key, int v) {
+   heap.push(make_pair(key, v));
+}
+
+//---------------------------------- pop ----------------------------------
+// Removes a vertex with the smallest key
+// Preconditions:  The queue is not empty
+// Postconditions: Returns the vertex and stores its key in key
+template <typename Key>
+int HeapQueue<Key>::pop(Key& key) {
+   key = heap.top().first;
+   int v = heap.top().second;
+   heap.pop();
+   return v;
+}
+
+//--------------------------------- empty ---------------------------------
+// Returns whether the queue holds no entries
+// Preconditions:  None
+// Postconditions: Returns true if nothing is left to pop
+template <typename Key>
+bool HeapQueue<Key>::empty() const {
+   return heap.empty();
+}
+
+//------------------------------ BucketQueue ------------------------------
+// BucketQueue constructor
+// Preconditions:  maxWeight is the largest edge weight expected
+// Postconditions: An empty queue with maxWeight + 1 buckets is created
+template <typename Key>
+BucketQueue<Key>::BucketQueue(Key maxWeight)
+   : buckets(static_cast<size_t>(maxWeight) + 1), current(0), count(0) {
+}
+
+//--------------------------------- push ----------------------------------
+// Adds a vertex with the given key
+// Preconditions:  key is not smaller than the last popped key
+// Postconditions: The (key, v) entry is in the queue. If key lies beyond
+//                 the bucket window, the window is widened first.
+template <typename Key>
+void BucketQueue<Key>::push(Key key, int v) {
+   // an edge heavier than maxWeight may be published while a query runs
+   if (static_cast<size_t>(key - current) >= buckets.size()) {
+      widen(key);
+   }
+   buckets[key % buckets.size()].push_back(v);
+   count++;
+}
+
+//---------------------------------- pop ----------------------------------
+// Removes a vertex with the smallest key
+// Preconditions:  The queue is not empty
+// Postconditions: Returns the vertex and stores its key in key
+template <typename Key>
+int BucketQueue<Key>::pop(Key& key) {
+   while (buckets[current % buckets.size()].empty()) {
+      current++;
+   }
+
+   vector<int>& bucket = buckets[current % buckets.size()];
+   int v = bucket.back();
+   bucket.pop_back();
+   count--;
+   key = current;
+   return v;
+}
+
+//--------------------------------- empty ---------------------------------
+// Returns whether the queue holds no entries
+// Preconditions:  None
+// Postconditions: Returns true if nothing is left to pop
+template <typename Key>
+bool BucketQueue<Key>::empty() const {
+   return count == 0;
+}
+
+//--------------------------------- widen ---------------------------------
+// Grows the window so that key fits
+// Preconditions:  key >= current
+// Postconditions: buckets.size() > key - current and all entries are kept
+template <typename Key>
+void BucketQueue<Key>::widen(Key key) {
+   size_t oldSize = buckets.size();
+   size_t newSize = oldSize * 2;
+   while (static_cast<size_t>(key - current) >= newSize) {
+      newSize *= 2;
+   }
+
+   // every entry lies in [current, current + oldSize), so its key is
+   // recovered from its position relative to current
+   vector<vector<int>> widened(newSize);
+   for (size_t offset = 0; offset < oldSize; offset++) {
+      size_t k = static_cast<size_t>(current) + offset;
+      widened[k % newSize].swap(buckets[k % oldSize]);
+   }
+   buckets.swap(widened);
+}
+
+//------------------------------- RadixHeap -------------------------------
+// RadixHeap constructor
+// Preconditions:  None
+// Postconditions: An empty heap with last popped key 0 is created
+template <typename Key>
+RadixHeap<Key>::RadixHeap() : last(0), count(0) {
+}
+
+//--------------------------------- push ----------------------------------
+// Adds a vertex with the given key
+// Preconditions:  key is not smaller than the last popped key
+// Postconditions: The (key, v) entry is in the queue
+template <typename Key>
+void RadixHeap<Key>::push(Key key, int v) {
+   Bits k = static_cast<Bits>(key);
+   buckets[bucketOf(k)].push_back(make_pair(k, v));
+   count++;
+}
+
+//---------------------------------- pop ----------------------------------
+// Removes a vertex with the smallest key
+// Preconditions:  The queue is not empty
+// Postconditions: Returns the vertex and stores its key in key
+template <typename Key>
+int RadixHeap<Key>::pop(Key& key) {
+   if (buckets[0].empty()) {
+      int b = 1;
+      while (buckets[b].empty()) {
+         b++;
+      }
+
+      // the minimum of the first non-empty bucket becomes the new last
+      // key; every entry of that bucket then moves to a lower bucket
+      Bits smallest = buckets[b][0].first;
+      for (size_t e = 1; e < buckets[b].size(); e++) {
+         if (buckets[b][e].first < smallest) {
+            smallest = buckets[b][e].first;
+         }
+      }
+      last = smallest;
+
+      for (size_t e = 0; e < buckets[b].size(); e++) {
+         buckets[bucketOf(buckets[b][e].first)].push_back(buckets[b][e]);
+      }
+      buckets[b].clear();
+   }
+
+   int v = buckets[0].back().second;
+   buckets[0].pop_back();
+   count--;
+   key = static_cast<Key>(last);
+   return v;
+}
+
+//--------------------------------- empty ---------------------------------
+// Returns whether the queue holds no entries
+// Preconditions:  None
+// Postconditions: Returns true if nothing is left to pop
+template <typename Key>
+bool RadixHeap<Key>::empty() const {
+   return count == 0;
+}
+
+//-------------------------------- bucketOf -------------------------------
+// Returns the bucket for a key relative to the last popped key
+// Preconditions:  key >= last
+// Postconditions: Returns 0 if key == last, otherwise the bit length of
+//                 key ^ last
+template <typename Key>
+int RadixHeap<Key>::bucketOf(Bits key) const {
+   Bits diff = static_cast<Bits>(key ^ last);
+   int bits = 0;
+   while (diff != 0) {
+      bits++;
+      diff >>= 1;
+   }
+   return bits;
+}
+
+template class HeapQueue<uint16_t>;
+template class HeapQueue<int32_t>;
+template class HeapQueue<int64_t>;
+template class HeapQueue<double>;
+template class BucketQueue<uint16_t>;
+template class BucketQueue<int32_t>;
+template class BucketQueue<int64_t>;
+template class RadixHeap<uint16_t>;
+template class RadixHeap<int32_t>;
+template class RadixHeap<int64_t>;
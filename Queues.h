@@ -0,0 +1,147 @@
+//--------------------------------------------------------------------
+// QUEUES.H
+// Declaration of the priority queues used by Dijkstra's algorithm
+// Author: [Your Name]
+//--------------------------------------------------------------------
+// HeapQueue, BucketQueue and RadixHeap classes:
+//   Min-priority queues of (key, vertex) pairs that share one interface
+//   so that findShortestPath can run with any of them. Decrease-key is
+//   done by pushing the vertex again; the caller skips stale entries.
+//      HeapQueue - binary heap, works for any non-negative keys
+//      BucketQueue - Dial's circular buckets, one per distance in a
+//                    window of maxWeight + 1
+//      RadixHeap - buckets by the highest bit that differs from the
+//                  last popped key
+//   Using the following methods:
+//      push - adds a vertex with the given key
+//      pop - removes and returns a vertex with the smallest key
+//      empty - returns whether the queue holds no entries
+//   Each queue is a template on the key (distance) type. HeapQueue is
+//   instantiated for uint16_t, int32_t, int64_t and double, the monotone
+//   queues for the integer types only.
+//   Assumptions:
+//      - Keys are non-negative
+//      - BucketQueue and RadixHeap are monotone: a pushed key is never
+//        smaller than the last popped key, which holds for Dijkstra's
+//        algorithm with non-negative edge weights
+//--------------------------------------------------------------------
+
+#pragma once
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+template <typename Key>
+class HeapQueue {
+public:
+   //--------------------------------- push ----------------------------------
+   // Adds a vertex with the given key
+   // Preconditions:  key is non-negative
+   // Postconditions: The (key, v) entry is in the queue
+   void push(Key key, int v);
+
+   //---------------------------------- pop ----------------------------------
+   // Removes a vertex with the smallest key
+   // Preconditions:  The queue is not empty
+   // Postconditions: Returns the vertex and stores its key in key
+   int pop(Key& key);
+
+   //--------------------------------- empty ---------------------------------
+   // Returns whether the queue holds no entries
+   // Preconditions:  None
+   // Postconditions: Returns true if nothing is left to pop
+   bool empty() const;
+
+private:
+   priority_queue<pair<Key, int>, vector<pair<Key, int>>,
+      greater<pair<Key, int>>> heap; // (key, vertex), smallest key on top
+};
+
+template <typename Key>
+class BucketQueue {
+public:
+   //------------------------------ BucketQueue ------------------------------
+   // BucketQueue constructor
+   // Preconditions:  maxWeight is the largest edge weight expected
+   // Postconditions: An empty queue with maxWeight + 1 buckets is created
+   BucketQueue(Key maxWeight);
+
+   //--------------------------------- push ----------------------------------
+   // Adds a vertex with the given key
+   // Preconditions:  key is not smaller than the last popped key
+   // Postconditions: The (key, v) entry is in the queue. If key lies beyond
+   //                 the bucket window, the window is widened first.
+   void push(Key key, int v);
+
+   //---------------------------------- pop ----------------------------------
+   // Removes a vertex with the smallest key
+   // Preconditions:  The queue is not empty
+   // Postconditions: Returns the vertex and stores its key in key
+   int pop(Key& key);
+
+   //--------------------------------- empty ---------------------------------
+   // Returns whether the queue holds no entries
+   // Preconditions:  None
+   // Postconditions: Returns true if nothing is left to pop
+   bool empty() const;
+
+private:
+   vector<vector<int>> buckets; // bucket key % buckets.size() holds vertices with that key
+   Key current; // smallest key that may still be in the queue
+   int count; // number of entries in all buckets
+
+   //--------------------------------- widen ---------------------------------
+   // Grows the window so that key fits
+   // Preconditions:  key >= current
+   // Postconditions: buckets.size() > key - current and all entries are kept
+   void widen(Key key);
+};
+
+template <typename Key>
+class RadixHeap {
+public:
+   //------------------------------- RadixHeap -------------------------------
+   // RadixHeap constructor
+   // Preconditions:  None
+   // Postconditions: An empty heap with last popped key 0 is created
+   RadixHeap();
+
+   //--------------------------------- push ----------------------------------
+   // Adds a vertex with the given key
+   // Preconditions:  key is not smaller than the last popped key
+   // Postconditions: The (key, v) entry is in the queue
+   void push(Key key, int v);
+
+   //---------------------------------- pop ----------------------------------
+   // Removes a vertex with the smallest key
+   // Preconditions:  The queue is not empty
+   // Postconditions: Returns the vertex and stores its key in key
+   int pop(Key& key);
+
+   //--------------------------------- empty ---------------------------------
+   // Returns whether the queue holds no entries
+   // Preconditions:  None
+   // Postconditions: Returns true if nothing is left to pop
+   bool empty() const;
+
+private:
+   typedef typename make_unsigned<Key>::type Bits;
+
+   // bucket 0 plus one per bit of the key
+   static const int BUCKETS = numeric_limits<Bits>::digits + 1;
+
+   vector<pair<Bits, int>> buckets[BUCKETS]; // (key, vertex)
+   Bits last; // last popped key
+   int count; // number of entries in all buckets
+
+   //-------------------------------- bucketOf -------------------------------
+   // Returns the bucket for a key relative to the last popped key
+   // Preconditions:  key >= last
+   // Postconditions: Returns 0 if key == last, otherwise the bit length of
+   //                 key ^ last
+   int bucketOf(Bits key) const;
+};
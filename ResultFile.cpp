@@ -0,0 +1,205 @@
+//--------------------------------------------------------------------
+// RESULTFILE.CPP
+// Implementation of the ResultFile class
+// Author: [Your Name]
+//--------------------------------------------------------------------
+// ResultFile class:
+//   A memory-mapped file holding one row of shortest path entries per
+//   source vertex, shared between the processes of a sharded all-pairs
+//   run.
+//   Assumptions:
+//      - Every process that writes the file writes disjoint rows
+//      - POSIX mmap is available
+//--------------------------------------------------------------------
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ResultFile.h"
+
+using namespace std;
+
+static const char MAGIC[8] = { 'H', 'W', '3', 'R', 'O', 'W', 'S', '2' };
+
+//--------------------------------- ResultFile --------------------------------
+// ResultFile constructor
+// Preconditions:  None
+// Postconditions: No file is mapped
+ResultFile::ResultFile() : base(nullptr), length(0) {
+}
+
+//--------------------------------- ~ResultFile -------------------------------
+// Destructor for the ResultFile class
+// Preconditions:  None
+// Postconditions: The file, if any, is unmapped; its contents stay on disk
+ResultFile::~ResultFile() {
+   close();
+}
+
+//----------------------------------- create ----------------------------------
+// Creates, sizes and maps a file for writing
+// Preconditions:  size >= 0 and entryBytes > 0
+// Postconditions: Returns true if path now holds an empty result file with
+//                 every row marked not done and is mapped shared and
+//                 writable; returns false and maps nothing otherwise.
+//                 entryType is stored for readers to check.
+bool ResultFile::create(const char* path, int size, size_t entryBytes, uint32_t entryType) {
+   close();
+
+   int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+   if (fd < 0) {
+      return false;
+   }
+
+   size_t bytes = fileLength(size, entryBytes);
+   if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) { // zero filled: no row is done
+      ::close(fd);
+      return false;
+   }
+
+   void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   ::close(fd);
+   if (mapped == MAP_FAILED) {
+      return false;
+   }
+
+   base = static_cast<unsigned char*>(mapped);
+   length = bytes;
+
+   Header* header = reinterpret_cast<Header*>(base);
+   memcpy(header->magic, MAGIC, sizeof(MAGIC));
+   header->size = static_cast<uint32_t>(size);
+   header->entryBytes = static_cast<uint32_t>(entryBytes);
+   header->entryType = entryType;
+   return true;
+}
+
+//------------------------------------ open -----------------------------------
+// Maps an existing file for reading
+// Preconditions:  None
+// Postconditions: Returns true if path holds a result file and it is
+//                 mapped read-only; returns false and maps nothing otherwise
+bool ResultFile::open(const char* path) {
+   close();
+
+   int fd = ::open(path, O_RDONLY);
+   if (fd < 0) {
+      return false;
+   }
+
+   struct stat info;
+   if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+      ::close(fd);
+      return false;
+   }
+
+   size_t bytes = static_cast<size_t>(info.st_size);
+   void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+   ::close(fd);
+   if (mapped == MAP_FAILED) {
+      return false;
+   }
+
+   base = static_cast<unsigned char*>(mapped);
+   length = bytes;
+
+   // reject other files and files truncated by a crash
+   const Header* header = reinterpret_cast<const Header*>(base);
+   if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->entryBytes == 0
+      || fileLength(static_cast<int>(header->size), header->entryBytes) != length) {
+      close();
+      return false;
+   }
+   return true;
+}
+
+//----------------------------------- close -----------------------------------
+// Unmaps the file
+// Preconditions:  None
+// Postconditions: No file is mapped
+void ResultFile::close() {
+   if (base != nullptr) {
+      munmap(base, length);
+      base = nullptr;
+      length = 0;
+   }
+}
+
+//----------------------------------- isOpen ----------------------------------
+// Returns whether a file is mapped
+// Preconditions:  None
+// Postconditions: Returns true between a successful create or open and close
+bool ResultFile::isOpen() const {
+   return base != nullptr;
+}
+
+//----------------------------------- getSize ---------------------------------
+// Returns the number of vertices the file was created for
+// Preconditions:  A file is mapped
+// Postconditions: Returns the size stored in the header
+int ResultFile::getSize() const {
+   return static_cast<int>(reinterpret_cast<const Header*>(base)->size);
+}
+
+//-------------------------------- getEntryBytes ------------------------------
+// Returns the size of one entry
+// Preconditions:  A file is mapped
+// Postconditions: Returns the entry size stored in the header
+size_t ResultFile::getEntryBytes() const {
+   return reinterpret_cast<const Header*>(base)->entryBytes;
+}
+
+//-------------------------------- getEntryType -------------------------------
+// Returns the entry type tag given to create
+// Preconditions:  A file is mapped
+// Postconditions: Returns the entry type stored in the header
+uint32_t ResultFile::getEntryType() const {
+   return reinterpret_cast<const Header*>(base)->entryType;
+}
+
+//------------------------------------ row ------------------------------------
+// Returns the first entry of a row
+// Preconditions:  A file is mapped and 1 <= src <= getSize()
+// Postconditions: Returns a pointer to entry 0 of row src; entry j starts
+//                 j * getEntryBytes() bytes later
+void* ResultFile::row(int src) const {
+   size_t rowBytes = (static_cast<size_t>(getSize()) + 1) * getEntryBytes();
+   return base + rowsOffset(getSize()) + src * rowBytes;
+}
+
+//----------------------------------- isDone ----------------------------------
+// Returns whether a row has been completed
+// Preconditions:  A file is mapped and 1 <= src <= getSize()
+// Postconditions: Returns true if markDone was called for src
+bool ResultFile::isDone(int src) const {
+   return base[sizeof(Header) + src] != 0;
+}
+
+//---------------------------------- markDone ---------------------------------
+// Marks a row as completed
+// Preconditions:  The file was mapped by create and the row has been written
+// Postconditions: The completion flag of src is set
+void ResultFile::markDone(int src) {
+   base[sizeof(Header) + src] = 1;
+}
+
+//-------------------------------- fileLength --------------------------------
+// Returns the number of bytes a result file needs
+// Preconditions:  None
+// Postconditions: Returns the header, flag and row bytes for size vertices
+size_t ResultFile::fileLength(int size, size_t entryBytes) {
+   size_t side = static_cast<size_t>(size) + 1;
+   return rowsOffset(size) + side * side * entryBytes;
+}
+
+//-------------------------------- rowsOffset --------------------------------
+// Returns the offset of row 0
+// Preconditions:  None
+// Postconditions: Returns the header and padded flag bytes for size vertices
+size_t ResultFile::rowsOffset(int size) {
+   size_t flags = sizeof(Header) + static_cast<size_t>(size) + 1;
+   return (flags + 7) / 8 * 8;
+}
@@ -0,0 +1,145 @@
+//--------------------------------------------------------------------
+// RESULTFILE.H
+// Declaration of the ResultFile class
+// Author: [Your Name]
+//--------------------------------------------------------------------
+// ResultFile class:
+//   A memory-mapped file holding one row of shortest path entries per
+//   source vertex, shared between the processes of a sharded all-pairs
+//   run. Each row has a completion flag that is set after the row data
+//   has been written, so a reader can tell finished rows from rows of a
+//   worker that died. The class only lays out bytes; the graph decides
+//   what an entry is and tags the file with an entry type so that a
+//   reader can refuse entries of another type that happen to have the
+//   same size.
+//   File layout:
+//      header (magic, size, entryBytes, entryType), size + 1 completion flags padded
+//      to 8 bytes, then (size + 1) rows of (size + 1) entries each; row 0
+//      and column 0 are unused because vertices are numbered from 1
+//   Using the following methods:
+//      ResultFile - constructor that creates an unmapped object
+//      ~ResultFile - destructor that unmaps the file
+//      create - creates, sizes and maps a file for writing
+//      open - maps an existing file for reading
+//      close - unmaps the file
+//      isOpen - returns whether a file is mapped
+//      getSize - returns the number of vertices the file was created for
+//      getEntryBytes - returns the size of one entry
+//      getEntryType - returns the entry type tag given to create
+//      row - returns the first entry of a row
+//      isDone - returns whether a row has been completed
+//      markDone - marks a row as completed
+//   Assumptions:
+//      - Every process that writes the file writes disjoint rows
+//      - POSIX mmap is available
+//--------------------------------------------------------------------
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+class ResultFile {
+public:
+   //--------------------------------- ResultFile --------------------------------
+   // ResultFile constructor
+   // Preconditions:  None
+   // Postconditions: No file is mapped
+   ResultFile();
+
+   //--------------------------------- ~ResultFile -------------------------------
+   // Destructor for the ResultFile class
+   // Preconditions:  None
+   // Postconditions: The file, if any, is unmapped; its contents stay on disk
+   ~ResultFile();
+
+   ResultFile(const ResultFile&) = delete;
+   ResultFile& operator=(const ResultFile&) = delete;
+
+   //----------------------------------- create ----------------------------------
+   // Creates, sizes and maps a file for writing
+   // Preconditions:  size >= 0 and entryBytes > 0
+   // Postconditions: Returns true if path now holds an empty result file with
+   //                 every row marked not done and is mapped shared and
+   //                 writable; returns false and maps nothing otherwise.
+   //                 entryType is stored for readers to check.
+   bool create(const char* path, int size, size_t entryBytes, uint32_t entryType);
+
+   //------------------------------------ open -----------------------------------
+   // Maps an existing file for reading
+   // Preconditions:  None
+   // Postconditions: Returns true if path holds a result file and it is
+   //                 mapped read-only; returns false and maps nothing otherwise
+   bool open(const char* path);
+
+   //----------------------------------- close -----------------------------------
+   // Unmaps the file
+   // Preconditions:  None
+   // Postconditions: No file is mapped
+   void close();
+
+   //----------------------------------- isOpen ----------------------------------
+   // Returns whether a file is mapped
+   // Preconditions:  None
+   // Postconditions: Returns true between a successful create or open and close
+   bool isOpen() const;
+
+   //----------------------------------- getSize ---------------------------------
+   // Returns the number of vertices the file was created for
+   // Preconditions:  A file is mapped
+   // Postconditions: Returns the size stored in the header
+   int getSize() const;
+
+   //-------------------------------- getEntryBytes ------------------------------
+   // Returns the size of one entry
+   // Preconditions:  A file is mapped
+   // Postconditions: Returns the entry size stored in the header
+   size_t getEntryBytes() const;
+
+   //-------------------------------- getEntryType -------------------------------
+   // Returns the entry type tag given to create
+   // Preconditions:  A file is mapped
+   // Postconditions: Returns the entry type stored in the header
+   uint32_t getEntryType() const;
+
+   //------------------------------------ row ------------------------------------
+   // Returns the first entry of a row
+   // Preconditions:  A file is mapped and 1 <= src <= getSize()
+   // Postconditions: Returns a pointer to entry 0 of row src; entry j starts
+   //                 j * getEntryBytes() bytes later
+   void* row(int src) const;
+
+   //----------------------------------- isDone ----------------------------------
+   // Returns whether a row has been completed
+   // Preconditions:  A file is mapped and 1 <= src <= getSize()
+   // Postconditions: Returns true if markDone was called for src
+   bool isDone(int src) const;
+
+   //---------------------------------- markDone ---------------------------------
+   // Marks a row as completed
+   // Preconditions:  The file was mapped by create and the row has been written
+   // Postconditions: The completion flag of src is set
+   void markDone(int src);
+
+private:
+   struct Header {
+      char magic[8]; // identifies a result file
+      uint32_t size; // number of vertices
+      uint32_t entryBytes; // bytes per entry
+      uint32_t entryType; // what an entry holds, chosen by the writer
+   };
+
+   unsigned char* base; // start of the mapping, nullptr if none
+   size_t length; // bytes mapped
+
+   //-------------------------------- fileLength --------------------------------
+   // Returns the number of bytes a result file needs
+   // Preconditions:  None
+   // Postconditions: Returns the header, flag and row bytes for size vertices
+   static size_t fileLength(int size, size_t entryBytes);
+
+   //-------------------------------- rowsOffset --------------------------------
+   // Returns the offset of row 0
+   // Preconditions:  None
+   // Postconditions: Returns the header and padded flag bytes for size vertices
+   static size_t rowsOffset(int size);
+};
@@ -0,0 +1,49 @@
+//--------------------------------------------------------------------
+// WEIGHTS.H
+// Declaration and definition of the WeightTraits template
+// Author: [Your Name]
+//--------------------------------------------------------------------
+// WeightTraits template:
+//   Describes the edge weight / path distance type a graph is built on
+//   using the following members:
+//      infinity - sentinel distance of an unreachable vertex
+//      add - adds an edge weight to a distance without overflowing
+//      isInteger - whether the monotone integer queues apply
+//   Assumptions:
+//      - Weights are non-negative
+//      - For integer types a distance that reaches the sentinel is treated
+//        as unreachable: add saturates at infinity() instead of wrapping
+//--------------------------------------------------------------------
+
+#pragma once
+#include <limits>
+#include <type_traits>
+
+using namespace std;
+
+template <typename Weight>
+struct WeightTraits {
+   static_assert(is_arithmetic<Weight>::value, "weights must be arithmetic");
+
+   static constexpr bool isInteger = is_integral<Weight>::value;
+
+   //-------------------------------- infinity ---------------------------------
+   // Returns the distance of an unreachable vertex
+   // Preconditions:  None
+   // Postconditions: Returns +infinity for floating point types and the
+   //                 largest value for integer types
+   static constexpr Weight infinity() {
+      return numeric_limits<Weight>::has_infinity ? numeric_limits<Weight>::infinity()
+         : numeric_limits<Weight>::max();
+   }
+
+   //----------------------------------- add -----------------------------------
+   // Adds an edge weight to a distance
+   // Preconditions:  dist and weight are non-negative
+   // Postconditions: Returns dist + weight, or infinity() if the sum does
+   //                 not fit below the sentinel
+   static constexpr Weight add(Weight dist, Weight weight) {
+      return isInteger && weight >= infinity() - dist ? infinity()
+         : static_cast<Weight>(dist + weight);
+   }
+};